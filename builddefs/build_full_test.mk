@@ -18,6 +18,7 @@ $(TEST_OUTPUT)_INC := \
 
 $(TEST_OUTPUT)_SRC := \
 	$(QUANTUM_SRC) \
+	$(QUANTUM_LIB_SRC) \
 	$(SRC) \
 	$(QUANTUM_PATH)/keymap_introspection.c \
 	tests/test_common/matrix.c \
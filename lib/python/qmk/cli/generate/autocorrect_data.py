@@ -13,7 +13,8 @@
 # limitations under the License.
 """Python program to make autocorrect_data.h.
 This program reads from a prepared dictionary file and generates a C source file
-"autocorrect_data.h" with a serialized trie embedded as an array. Run this
+"autocorrect_data.h" with a serialized Aho-Corasick automaton embedded as an
+array, so the firmware matches typos incrementally as keys are typed. Run this
 program and pass it as the first argument like:
 $ qmk generate-autocorrect-data autocorrect_dict.txt
 Each line of the dict file defines one typo and its correction with the syntax
@@ -28,6 +29,7 @@ For full documentation, see QMK Docs
 """
 
 import textwrap
+from collections import deque
 from typing import Any, Dict, Iterator, List, Tuple
 
 from milc import cli
@@ -49,6 +51,10 @@ TYPO_CHARS = dict([
 ] + [(chr(c), c + KC_A - ord('a')) for c in range(ord('a'),
                                                   ord('z') + 1)])  # Characters a-z.
 
+# The automaton stores keycodes in 5 bits, the word break and apostrophe take the codes after KC_Z.
+KC_Z = KC_A + 25
+NODE_CODES = {**TYPO_CHARS, ':': KC_Z + 1, "'": KC_Z + 2}
+
 
 def parse_file(file_name: str) -> List[Tuple[str, str]]:
     """Parses autocorrections dictionary file.
@@ -107,21 +113,41 @@ def parse_file(file_name: str) -> List[Tuple[str, str]]:
     return autocorrections
 
 
-def make_trie(autocorrections: List[Tuple[str, str]]) -> Dict[str, Any]:
-    """Makes a trie from the the typos, writing in reverse.
+def make_automaton(autocorrections: List[Tuple[str, str]]) -> List[Dict[str, Any]]:
+    """Makes an Aho-Corasick automaton from the typos.
+  The trie of the typos, written forwards, is completed with failure links: the
+  failure link of a node points to the node of the longest proper suffix of its
+  string that is also in the trie. As typos may not be substrings of one
+  another, a typo can only be found at its own leaf.
   Args:
     autocorrections: List of (typo, correction) tuples.
   Returns:
-    Dict of dict, representing the trie.
+    List of nodes, root first. Each node is a dict with 'children' (a dict from
+    character to node index), 'depth' (the length of its string), 'fail' (a node
+    index) and, for leaves, 'leaf' holding the (typo, correction) tuple.
   """
-    trie = {}
+    nodes = [{'children': {}, 'depth': 0, 'fail': 0}]
     for typo, correction in autocorrections:
-        node = trie
-        for letter in typo[::-1]:
-            node = node.setdefault(letter, {})
-        node['LEAF'] = (typo, correction)
-
-    return trie
+        node = 0
+        for letter in typo:
+            if letter not in nodes[node]['children']:
+                nodes[node]['children'][letter] = len(nodes)
+                nodes.append({'children': {}, 'depth': nodes[node]['depth'] + 1, 'fail': 0})
+            node = nodes[node]['children'][letter]
+        nodes[node]['leaf'] = (typo, correction)
+
+    # Compute failure links in breadth first order, so the links of shorter strings are known first.
+    queue = deque(nodes[0]['children'].values())
+    while queue:
+        node = queue.popleft()
+        for letter, child in nodes[node]['children'].items():
+            fail = nodes[node]['fail']
+            while fail and letter not in nodes[fail]['children']:
+                fail = nodes[fail]['fail']
+            nodes[child]['fail'] = nodes[fail]['children'].get(letter, 0)
+            queue.append(child)
+
+    return nodes
 
 
 def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str, str]]:
@@ -165,76 +191,84 @@ def check_typo_against_dictionary(typo: str, line_number: int, correct_words) ->
                 cli.log.warning('{fg_yellow}Warning:%d:{fg_reset} Typo "{fg_cyan}%s{fg_reset}" would falsely trigger on correctly spelled word "{fg_cyan}%s{fg_reset}".', line_number, typo, word)
 
 
-def serialize_trie(autocorrections: List[Tuple[str, str]], trie: Dict[str, Any]) -> List[int]:
-    """Serializes trie and correction data in a form readable by the C code.
+def serialize_automaton(nodes: List[Dict[str, Any]]) -> List[int]:
+    """Serializes the automaton and correction data in a form readable by the C code.
+  Failure links are not stored as links. Each inner node stores how the length
+  of its failure link relates to the length of its parent's, and the firmware
+  finds the node a failure link leads to by walking down from the root with
+  the last keycodes typed.
   Args:
-    autocorrections: List of (typo, correction) tuples.
-    trie: Dict of dicts.
+    nodes: List of nodes, as returned by make_automaton.
   Returns:
     List of ints in the range 0-255.
   """
-    table = []
-
-    # Traverse trie in depth first order.
-    def traverse(trie_node):
-        if 'LEAF' in trie_node:  # Handle a leaf trie node.
-            typo, correction = trie_node['LEAF']
-            word_boundary_ending = typo[-1] == ':'
-            typo = typo.strip(':')
-            i = 0  # Make the autocorrection data for this entry and serialize it.
-            while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
-                i += 1
-            backspaces = len(typo) - i - 1 + word_boundary_ending
-            assert 0 <= backspaces <= 63
-            correction = correction[i:]
-            bs_count = [backspaces + 128]
-            data = bs_count + list(bytes(correction, 'ascii')) + [0]
-
-            entry = {'data': data, 'links': [], 'byte_offset': 0}
-            table.append(entry)
-        elif len(trie_node) == 1:  # Handle trie node with a single child.
-            c, trie_node = next(iter(trie_node.items()))
-            entry = {'chars': c, 'byte_offset': 0}
-
-            # It's common for a trie to have long chains of single-child nodes. We
-            # find the whole chain so that we can serialize it more efficiently.
-            while len(trie_node) == 1 and 'LEAF' not in trie_node:
-                c, trie_node = next(iter(trie_node.items()))
-                entry['chars'] += c
-
-            table.append(entry)
-            entry['links'] = [traverse(trie_node)]
-        else:  # Handle trie node with multiple children.
-            entry = {'chars': ''.join(sorted(trie_node.keys())), 'byte_offset': 0}
-            table.append(entry)
-            entry['links'] = [traverse(trie_node[c]) for c in entry['chars']]
-        return entry
-
-    traverse(trie)
-
-    def serialize(e: Dict[str, Any]) -> List[int]:
-        if not e['links']:  # Handle a leaf table entry.
-            return e['data']
-        elif len(e['links']) == 1:  # Handle a chain table entry.
-            return [TYPO_CHARS[c] for c in e['chars']] + [0]  # + encode_link(e['links'][0]))
-        else:  # Handle a branch table entry.
-            data = []
-            for c, link in zip(e['chars'], e['links']):
-                data += [TYPO_CHARS[c] | (0 if data else 64)] + encode_link(link)
-            return data + [0]
-
+    # Nodes are laid out in depth first order, so that the first child of a node
+    # always follows it immediately and needs no link.
+    order = []
+    fail_step = {0: 0}
+
+    def children(node: int) -> List[Tuple[str, int]]:
+        return sorted(nodes[node]['children'].items(), key=lambda item: NODE_CODES[item[0]])
+
+    def traverse(node):
+        order.append(node)
+        for _, child in children(node):
+            # The failure link of a child is at most one longer than its parent's.
+            if node:
+                fail_step[child] = nodes[nodes[node]['fail']]['depth'] + 1 - nodes[nodes[child]['fail']]['depth']
+            else:
+                fail_step[child] = 0
+            traverse(child)
+
+    traverse(0)
+
+    def leaf_data(node: Dict[str, Any]) -> List[int]:
+        typo, correction = node['leaf']
+        word_boundary_ending = typo[-1] == ':'
+        typo = typo.strip(':')
+        i = 0  # Make the autocorrection data for this entry and serialize it.
+        while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
+            i += 1
+        backspaces = len(typo) - i - 1 + word_boundary_ending
+        assert 0 <= backspaces <= 63
+        return [backspaces + 128] + list(bytes(correction[i:], 'ascii')) + [0]
+
+    def node_data(node: int, offsets: Dict[int, int]) -> List[int]:
+        if 'leaf' in nodes[node]:
+            return leaf_data(nodes[node])
+
+        # Steps of 3 or more are rare, they take an extra byte.
+        step = fail_step[node]
+        data = [min(step, 3) << 5]
+        if step >= 3:
+            data.append(step)
+
+        # A single child is stored in the first byte, so chains of single-child nodes like f-i-t-l take 1 byte per node.
+        node_children = children(node)
+        if len(node_children) == 1:
+            data[0] |= NODE_CODES[node_children[0][0]]
+            return data
+
+        data += [len(node_children), NODE_CODES[node_children[0][0]]]
+        for letter, child in node_children[1:]:
+            data += [NODE_CODES[letter]] + encode_link(offsets.get(child, 0))
+        return data
+
+    offsets = {}
     byte_offset = 0
-    for e in table:  # To encode links, first compute byte offset of each entry.
-        e['byte_offset'] = byte_offset
-        byte_offset += len(serialize(e))
-        assert 0 <= byte_offset <= 0xffff
+    for node in order:  # To encode links, first compute byte offset of each node.
+        offsets[node] = byte_offset
+        byte_offset += len(node_data(node, offsets))
+
+    data = []
+    for node in order:
+        data += node_data(node, offsets)
 
-    return [b for e in table for b in serialize(e)]  # Serialize final table.
+    return data
 
 
-def encode_link(link: Dict[str, Any]) -> List[int]:
+def encode_link(byte_offset: int) -> List[int]:
     """Encodes a node link as two bytes."""
-    byte_offset = link['byte_offset']
     if not (0 <= byte_offset <= 0xffff):
         cli.log.error('{fg_red}Error:{fg_reset} The autocorrection table is too large, a node link exceeds 64KB limit. Try reducing the autocorrection dict to fewer entries.')
         maybe_exit(1)
@@ -257,8 +291,8 @@ def to_hex(b: int) -> str:
 @cli.subcommand('Generate the autocorrection data file from a dictionary file.')
 def generate_autocorrect_data(cli):
     autocorrections = parse_file(cli.args.filename)
-    trie = make_trie(autocorrections)
-    data = serialize_trie(autocorrections, trie)
+    nodes = make_automaton(autocorrections)
+    data = serialize_automaton(nodes)
 
     current_keyboard = cli.args.keyboard or cli.config.user.keyboard or cli.config.generate_autocorrect_data.keyboard
     current_keymap = cli.args.keymap or cli.config.user.keymap or cli.config.generate_autocorrect_data.keymap
@@ -282,6 +316,7 @@ def generate_autocorrect_data(cli):
     autocorrect_data_h_lines.append(f'#define AUTOCORRECT_MIN_LENGTH {len(min_typo)} // "{min_typo}"')
     autocorrect_data_h_lines.append(f'#define AUTOCORRECT_MAX_LENGTH {len(max_typo)} // "{max_typo}"')
     autocorrect_data_h_lines.append(f'#define DICTIONARY_SIZE {len(data)}')
+    autocorrect_data_h_lines.append('#define AUTOCORRECT_AUTOMATON')
     autocorrect_data_h_lines.append('')
     autocorrect_data_h_lines.append('static const uint8_t autocorrect_data[DICTIONARY_SIZE] PROGMEM = {')
     autocorrect_data_h_lines.append(textwrap.fill('    %s' % (', '.join(map(to_hex, data))), width=100, subsequent_indent='    '))
@@ -0,0 +1,31 @@
+import random
+
+from qmk.cli.generate.autocorrect_data import make_automaton, serialize_automaton
+
+
+def make_dictionary(count):
+    """Makes up `count` typos of random words, none of them a substring of another.
+
+    Letters are drawn with their frequency in English, so that typos share prefixes and failure links like real ones.
+    """
+    rng = random.Random(0)
+    letters = 'etaoinshrdlcumwfgypbvkjxqz'
+    weights = [12, 9, 8, 7, 7, 6.7, 6.3, 6, 6, 4.3, 4, 2.8, 2.8, 2.4, 2.4, 2.2, 2, 2, 1.9, 1.5, 1, .8, .15, .15, .1, .07]
+    autocorrections = {}
+    substrings = set()
+    while len(autocorrections) < count:
+        word = ''.join(rng.choices(letters, weights, k=rng.randint(5, 10)))
+        i = rng.randrange(len(word) - 1)
+        typo = word[:i] + word[i + 1] + word[i] + word[i + 2:]
+        parts = {typo[a:b] for a in range(len(typo)) for b in range(a + 1, len(typo) + 1)}
+        if typo == word or typo in substrings or parts & autocorrections.keys():
+            continue
+        autocorrections[typo] = word
+        substrings |= parts
+    return list(autocorrections.items())
+
+
+def test_serialize_automaton_large_dictionary():
+    data = serialize_automaton(make_automaton(make_dictionary(3000)))
+    assert len(data) <= 0xffff
+    assert all(0 <= b <= 255 for b in data)
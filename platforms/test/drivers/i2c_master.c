@@ -0,0 +1,58 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "i2c_master.h"
+
+static uint32_t write_transfers = 0;
+static uint32_t bytes_written   = 0;
+
+static i2c_status_t i2c_mock_write(uint16_t length) {
+    write_transfers++;
+    bytes_written += length;
+    return I2C_STATUS_SUCCESS;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_mock_write(length);
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    memset(data, 0, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_mock_write(length + 1);
+}
+
+i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_mock_write(length + 2);
+}
+
+i2c_status_t i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_receive(devaddr, data, length, timeout);
+}
+
+i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_receive(devaddr, data, length, timeout);
+}
+
+i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout) {
+    return I2C_STATUS_SUCCESS;
+}
+
+void i2c_mock_reset(void) {
+    write_transfers = 0;
+    bytes_written   = 0;
+}
+
+uint32_t i2c_mock_write_transfers(void) {
+    return write_transfers;
+}
+
+uint32_t i2c_mock_bytes_written(void) {
+    return bytes_written;
+}
@@ -16,6 +16,7 @@
 
 #include "timer.h"
 #include <stdatomic.h>
+#include <time.h>
 
 static atomic_uint_least32_t current_time      = 0;
 static atomic_uint_least32_t async_tick_amount = 0;
@@ -81,3 +82,10 @@ void advance_time(uint32_t ms) {
 void wait_ms(uint32_t ms) {
     advance_time(ms);
 }
+
+// Profiling uses the host's monotonic clock in nanoseconds, independent of the simulated time above.
+uint32_t profiling_timestamp(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
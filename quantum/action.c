@@ -44,6 +44,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    include "encoder.h"
 #endif
 
+#ifdef PROFILING_LATENCY_TRACE
+#    include "profiling.h"
+#endif
+
 int tp_buttons;
 
 #if defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY) || (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
@@ -72,6 +76,9 @@ __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *reco
  */
 void action_exec(keyevent_t event) {
     if (IS_EVENT(event)) {
+#ifdef PROFILING_LATENCY_TRACE
+        profiling_latency_exec(event.time);
+#endif
         ac_dprintf("\n---- action_exec: start -----\n");
         ac_dprintf("EVENT: ");
         debug_event(event);
@@ -134,6 +141,34 @@ void action_exec(keyevent_t event) {
 #endif
 }
 
+/** \brief Whether tick events still have timeouts to drive
+ *
+ * Ticks settle the tapping key and expire oneshot mods and layers. Without
+ * either in progress, a tick event has no effect and can be skipped.
+ */
+bool action_tick_pending(void) {
+#ifndef NO_ACTION_ONESHOT
+#    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
+    if (keymap_config.oneshot_enable) {
+        if (get_oneshot_mods() || get_oneshot_layer_state()) {
+            return true;
+        }
+#        ifdef SWAP_HANDS_ENABLE
+        if (is_oneshot_swaphands_active()) {
+            return true;
+        }
+#        endif
+    }
+#    endif
+#endif
+
+#ifndef NO_ACTION_TAPPING
+    return !action_tapping_idle();
+#else
+    return false;
+#endif
+}
+
 #ifdef SWAP_HANDS_ENABLE
 extern const keypos_t PROGMEM hand_swap_config[MATRIX_ROWS][MATRIX_COLS];
 #    ifdef ENCODER_MAP_ENABLE
@@ -271,17 +306,24 @@ void process_record(keyrecord_t *record) {
         return;
     }
 
+#ifdef PROFILING_LATENCY_TRACE
+    profiling_latency_t previous_latency = profiling_latency_process_begin(record->event.time);
+#endif
+
     if (!process_record_quantum(record)) {
 #ifndef NO_ACTION_ONESHOT
         if (is_oneshot_layer_active() && record->event.pressed && keymap_config.oneshot_enable) {
             clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
         }
 #endif
-        return;
+    } else {
+        process_record_handler(record);
+        post_process_record_quantum(record);
     }
 
-    process_record_handler(record);
-    post_process_record_quantum(record);
+#ifdef PROFILING_LATENCY_TRACE
+    profiling_latency_process_end(previous_latency);
+#endif
 }
 
 void process_record_handler(keyrecord_t *record) {
@@ -1,10 +1,12 @@
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "keyboard.h"
 #include "action.h"
 #include "encoder.h"
 #include "util.h"
+#include "matrix.h"
 #include "action_layer.h"
 
 /** \brief Default Layer State
@@ -316,11 +318,30 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#if defined(LAYER_LOOKUP_CACHE_ENABLE) && !defined(NO_ACTION_LAYER)
+/** \brief layer lookup cache
  *
- * Gets the layer based on key info
+ * Resolved source layer for every matrix position, filled lazily per key and
+ * dropped whenever the effective layer state or the keymap changes.
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
+static uint8_t       layer_lookup_cache[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t  layer_lookup_cache_valid[MATRIX_ROWS] = {0};
+static layer_state_t layer_lookup_cache_state              = 0;
+
+/** \brief Layer lookup cache invalidate
+ *
+ * Drops all cached entries, must be called whenever the keymap contents change
+ */
+void layer_lookup_cache_invalidate(void) {
+    memset(layer_lookup_cache_valid, 0, sizeof(layer_lookup_cache_valid));
+}
+#endif
+
+/** \brief Layer switch walk layers
+ *
+ * Walks the active layers from the top down to find the first non-transparent one
+ */
+static uint8_t layer_switch_walk_layers(keypos_t key) {
 #ifndef NO_ACTION_LAYER
     action_t action;
     action.code = ACTION_TRANSPARENT;
@@ -342,6 +363,30 @@ uint8_t layer_switch_get_layer(keypos_t key) {
 #endif
 }
 
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#if defined(LAYER_LOOKUP_CACHE_ENABLE) && !defined(NO_ACTION_LAYER)
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        layer_state_t layers = layer_state | default_layer_state;
+        if (layers != layer_lookup_cache_state) {
+            layer_lookup_cache_invalidate();
+            layer_lookup_cache_state = layers;
+        }
+
+        const matrix_row_t col_mask = (matrix_row_t)1 << key.col;
+        if (!(layer_lookup_cache_valid[key.row] & col_mask)) {
+            layer_lookup_cache[key.row][key.col] = layer_switch_walk_layers(key);
+            layer_lookup_cache_valid[key.row] |= col_mask;
+        }
+        return layer_lookup_cache[key.row][key.col];
+    }
+#endif
+    return layer_switch_walk_layers(key);
+}
+
 /** \brief Layer switch get layer
  *
  * Gets action code based on key position
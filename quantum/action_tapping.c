@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "action.h"
 #include "action_layer.h"
@@ -59,14 +60,48 @@ __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyreco
 #        include "process_auto_shift.h"
 #    endif
 
-static keyrecord_t tapping_key                         = {};
-static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+#    if WAITING_BUFFER_SIZE < 2 || WAITING_BUFFER_SIZE > 128
+#        error WAITING_BUFFER_SIZE must be between 2 and 128
+#    endif
+
+// Size of the key index: a power of two, at least twice the buffer size so it never fills up.
+#    if WAITING_BUFFER_SIZE <= 4
+#        define WAITING_KEYS_SIZE 8
+#    elif WAITING_BUFFER_SIZE <= 8
+#        define WAITING_KEYS_SIZE 16
+#    elif WAITING_BUFFER_SIZE <= 16
+#        define WAITING_KEYS_SIZE 32
+#    elif WAITING_BUFFER_SIZE <= 32
+#        define WAITING_KEYS_SIZE 64
+#    elif WAITING_BUFFER_SIZE <= 64
+#        define WAITING_KEYS_SIZE 128
+#    else
+#        define WAITING_KEYS_SIZE 256
+#    endif
+
+/* Number of press and release events of a key in the waiting buffer.
+ * An entry with both counts at zero is free.
+ */
+typedef struct {
+    keypos_t key;
+    uint8_t  pressed;
+    uint8_t  released;
+} waiting_key_t;
+
+static keyrecord_t            tapping_key                         = {};
+static keyrecord_t            waiting_buffer[WAITING_BUFFER_SIZE] = {};
+static uint8_t                waiting_buffer_tail                 = 0;
+static uint8_t                waiting_buffer_count                = 0;
+static uint8_t                waiting_buffer_pressed              = 0;
+static waiting_key_t          waiting_keys[WAITING_KEYS_SIZE]     = {};
+static waiting_buffer_stats_t waiting_buffer_stats                = {};
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
+static void waiting_buffer_process(void);
+static void waiting_buffer_overflow(keyrecord_t record);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -86,30 +121,78 @@ void action_tapping_process(keyrecord_t record) {
         }
     } else {
         if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){0};
+            waiting_buffer_overflow(record);
         }
     }
 
     // process waiting_buffer
-    if (IS_EVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
+    if (IS_EVENT(record.event) && waiting_buffer_count > 0) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    waiting_buffer_process();
+    if (IS_EVENT(record.event)) {
+        ac_dprintf("\n");
+    }
+}
+
+/** \brief Process the waiting buffer until an event has to wait again
+ */
+static void waiting_buffer_process(void) {
+    while (waiting_buffer_count > 0) {
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
             debug_record(waiting_buffer[waiting_buffer_tail]);
             ac_dprintf("\n\n");
+            waiting_buffer_deq();
         } else {
             break;
         }
     }
-    if (IS_EVENT(record.event)) {
-        ac_dprintf("\n");
+}
+
+/** \brief Make room for a record when the waiting buffer is full
+ *
+ * The only thing events wait for is the tapping key to be settled: as so many
+ * keys were typed in the meantime, settle it as held and process the buffer.
+ * Everything is cleared only if that still does not make room.
+ */
+static void waiting_buffer_overflow(keyrecord_t record) {
+    ac_dprintf("waiting_buffer: OVERFLOW, settling the tapping key\n");
+    waiting_buffer_stats.overflows++;
+
+    if (tapping_key.event.pressed && tapping_key.tap.count == 0) {
+        process_record(&tapping_key);
     }
+    tapping_key = (keyrecord_t){0};
+    debug_tapping_key();
+    waiting_buffer_process();
+
+    // Events still waiting, e.g. for a tap-hold key that became the tapping key, go first.
+    if ((waiting_buffer_count == 0 && process_tapping(&record)) || waiting_buffer_enq(record)) {
+        return;
+    }
+
+    ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
+    clear_keyboard();
+    waiting_buffer_clear();
+    tapping_key = (keyrecord_t){0};
+}
+
+/** \brief Whether the tapping state machine has nothing left to settle
+ *
+ * Tick events are only needed to time out the tapping key and release the
+ * events waiting for it.
+ */
+bool action_tapping_idle(void) {
+    return IS_NOEVENT(tapping_key.event) && waiting_buffer_count == 0;
+}
+
+const waiting_buffer_stats_t *waiting_buffer_get_stats(void) {
+    return &waiting_buffer_stats;
+}
+
+void waiting_buffer_reset_stats(void) {
+    waiting_buffer_stats = (waiting_buffer_stats_t){.peak_depth = waiting_buffer_count};
 }
 
 /* Some conditionally defined helper macros to keep process_tapping more
@@ -432,48 +515,125 @@ bool process_tapping(keyrecord_t *keyp) {
     }
 }
 
+static uint8_t waiting_key_hash(keypos_t key) {
+    return (uint8_t)(key.row * 7 + key.col) & (WAITING_KEYS_SIZE - 1);
+}
+
+static bool waiting_key_is_free(const waiting_key_t *entry) {
+    return entry->pressed == 0 && entry->released == 0;
+}
+
+/** \brief Index of the entry of a key in the key index, or of the free entry where it belongs
+ */
+static uint8_t waiting_key_find(keypos_t key) {
+    uint8_t i = waiting_key_hash(key);
+    while (!waiting_key_is_free(&waiting_keys[i]) && !KEYEQ(waiting_keys[i].key, key)) {
+        i = (i + 1) & (WAITING_KEYS_SIZE - 1);
+    }
+    return i;
+}
+
+static void waiting_key_add(keyevent_t event) {
+    waiting_key_t *entry = &waiting_keys[waiting_key_find(event.key)];
+    entry->key           = event.key;
+    if (event.pressed) {
+        entry->pressed++;
+        waiting_buffer_pressed++;
+    } else {
+        entry->released++;
+    }
+}
+
+static void waiting_key_remove(keyevent_t event) {
+    uint8_t        i     = waiting_key_find(event.key);
+    waiting_key_t *entry = &waiting_keys[i];
+    if (waiting_key_is_free(entry)) {
+        return;
+    }
+    if (event.pressed) {
+        entry->pressed--;
+        waiting_buffer_pressed--;
+    } else {
+        entry->released--;
+    }
+    if (!waiting_key_is_free(entry)) {
+        return;
+    }
+
+    // Free the entry, moving back the following ones that would no longer be found past it.
+    for (uint8_t j = (i + 1) & (WAITING_KEYS_SIZE - 1); !waiting_key_is_free(&waiting_keys[j]); j = (j + 1) & (WAITING_KEYS_SIZE - 1)) {
+        uint8_t home = waiting_key_hash(waiting_keys[j].key);
+        if (((uint8_t)(j - home) & (WAITING_KEYS_SIZE - 1)) >= ((uint8_t)(j - i) & (WAITING_KEYS_SIZE - 1))) {
+            waiting_keys[i] = waiting_keys[j];
+            i               = j;
+        }
+    }
+    waiting_keys[i] = (waiting_key_t){0};
+}
+
+static const waiting_key_t *waiting_key_get(keypos_t key) {
+    const waiting_key_t *entry = &waiting_keys[waiting_key_find(key)];
+    return waiting_key_is_free(entry) ? NULL : entry;
+}
+
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Appends a record to the waiting buffer, returns false if it is full.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (waiting_buffer_count == WAITING_BUFFER_SIZE) {
         ac_dprintf("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
-    waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer[(waiting_buffer_tail + waiting_buffer_count) % WAITING_BUFFER_SIZE] = record;
+    waiting_buffer_count++;
+    waiting_key_add(record.event);
+
+    if (waiting_buffer_count > waiting_buffer_stats.peak_depth) {
+        waiting_buffer_stats.peak_depth = waiting_buffer_count;
+    }
 
     ac_dprintf("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Drops the oldest record of the waiting buffer.
+ */
+void waiting_buffer_deq(void) {
+    waiting_key_remove(waiting_buffer[waiting_buffer_tail].event);
+    waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_count--;
+}
+
 /** \brief Waiting buffer clear
  *
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_tail    = 0;
+    waiting_buffer_count   = 0;
+    waiting_buffer_pressed = 0;
+    memset(waiting_keys, 0, sizeof(waiting_keys));
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Whether the waiting buffer holds an event of the same key in the opposite state.
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
-            return true;
-        }
+    const waiting_key_t *entry = waiting_key_get(event.key);
+    if (!entry) {
+        return false;
     }
-    return false;
+    return event.pressed ? entry->released > 0 : entry->pressed > 0;
 }
 
 /** \brief Waiting buffer has anykey pressed
@@ -481,10 +641,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_pressed > 0;
 }
 
 /** \brief Scan buffer for tapping
@@ -499,10 +656,17 @@ void waiting_buffer_scan_tap(void) {
         return;
     }
 
+    // early return if the tapping key has not been released yet
+    const waiting_key_t *entry = waiting_key_get(tapping_key.event.key);
+    if (!entry || entry->released == 0) {
+        return;
+    }
+
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT))
     TAP_DEFINE_KEYCODE;
 #    endif
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t n = 0; n < waiting_buffer_count; n++) {
+        uint8_t      i         = (waiting_buffer_tail + n) % WAITING_BUFFER_SIZE;
         keyrecord_t *candidate = &waiting_buffer[i];
         // clang-format off
         if (IS_EVENT(candidate->event) && KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed && (
@@ -536,7 +700,8 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     ac_dprintf("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t n = 0; n < waiting_buffer_count; n++) {
+        uint8_t i = (waiting_buffer_tail + n) % WAITING_BUFFER_SIZE;
         ac_dprintf("[%u]=", i);
         debug_record(waiting_buffer[i]);
         ac_dprintf(" ");
@@ -32,12 +32,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of key events that can wait for a tapping key to be settled */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
+
+typedef struct {
+    uint8_t  peak_depth; // most events waiting at once
+    uint16_t overflows;  // times the buffer was full
+} waiting_buffer_stats_t;
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 void     action_tapping_process(keyrecord_t record);
+bool     action_tapping_idle(void);
+
+/* waiting buffer statistics, since startup or the last reset */
+const waiting_buffer_stats_t *waiting_buffer_get_stats(void);
+void                          waiting_buffer_reset_stats(void);
 #endif
 
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
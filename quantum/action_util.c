@@ -109,6 +109,10 @@ enum {
     SHO_PRESSED, // Swap hands button is currently pressed
     SHO_USED,    // Swap hands button is still pressed, and we already sent swapped keys
 } swap_hands_oneshot = SHO_OFF;
+
+bool is_oneshot_swaphands_active(void) {
+    return swap_hands_oneshot == SHO_ACTIVE;
+}
 #    endif
 
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
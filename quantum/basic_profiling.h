@@ -21,16 +21,14 @@
         });
 */
 
-#if defined(PROTOCOL_LUFA) || defined(PROTOCOL_VUSB)
-#    define TIMESTAMP_GETTER TCNT0
-#elif defined(PROTOCOL_CHIBIOS)
-#    define TIMESTAMP_GETTER chSysGetRealtimeCounterX()
-#elif defined(PROTOCOL_ARM_ATSAM)
+#if defined(PROTOCOL_ARM_ATSAM)
 #    error arm_atsam not currently supported
-#else
-#    error Unknown protocol in use
 #endif
 
+// For min/max/average and histograms of named zones, see profiling.h.
+#include "profiling.h"
+#define TIMESTAMP_GETTER PROFILING_TIMESTAMP()
+
 #ifndef CONSOLE_ENABLE
 // Can't do anything if we don't have console output enabled.
 #    define PROFILE_CALL_NAMED(count, name, call) \
@@ -19,82 +19,72 @@
 #include "progmem.h"
 #include "util.h"
 
-RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+// Which of v, p, q and t goes to the red, green and blue channels, two bits each, for every
+// sixth of the hue circle. The seventh entry is for hue 255 and wraps around to red.
+static const uint8_t hsv_region_channels[7] PROGMEM = {
+    0 | (3 << 2) | (1 << 4), // v, t, p
+    2 | (0 << 2) | (1 << 4), // q, v, p
+    1 | (0 << 2) | (3 << 4), // p, v, t
+    1 | (2 << 2) | (0 << 4), // p, q, v
+    3 | (1 << 2) | (0 << 4), // t, p, v
+    0 | (1 << 2) | (2 << 4), // v, p, q
+    0 | (3 << 2) | (1 << 4), // v, t, p
+};
 
-    if (hsv.s == 0) {
-#ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
+// The products below need all 16 bits, so they are computed on uint16_t. Where int is 16 bits wide, as on AVR, uint8_t
+// operands would be promoted to signed int and overflow. The tests swap this type for one emulating 16-bit int.
+#ifndef HSV_TO_RGB_UINT16
+#    define HSV_TO_RGB_UINT16 uint16_t
 #endif
+
+static inline RGB hsv_to_rgb_kernel(HSV_TO_RGB_UINT16 h, HSV_TO_RGB_UINT16 s, HSV_TO_RGB_UINT16 v) {
+    RGB rgb;
+
+    if (s == 0) {
+        rgb.r = (uint8_t)v;
+        rgb.g = (uint8_t)v;
+        rgb.b = (uint8_t)v;
         return rgb;
     }
 
-    h = hsv.h;
-    s = hsv.s;
+    uint8_t region    = (uint8_t)(h * 6 / 255);
+    uint8_t remainder = (uint8_t)((h * 2 - region * 85) * 3);
+
+    uint8_t channels[4];
+    channels[0] = (uint8_t)v;
+    channels[1] = (uint8_t)((v * (255 - s)) >> 8);
+    channels[2] = (uint8_t)((v * (255 - ((s * remainder) >> 8))) >> 8);
+    channels[3] = (uint8_t)((v * (255 - ((s * (255 - remainder)) >> 8))) >> 8);
+
+    uint8_t map = pgm_read_byte(&hsv_region_channels[region]);
+    rgb.r       = channels[map & 3];
+    rgb.g       = channels[(map >> 2) & 3];
+    rgb.b       = channels[map >> 4];
+
+    return rgb;
+}
+
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
 #ifdef USE_CIE1931_CURVE
     if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
+        return hsv_to_rgb_kernel(hsv.h, hsv.s, pgm_read_byte(&CIE1931_CURVE[hsv.v]));
     }
-#else
-    v = hsv.v;
 #endif
+    return hsv_to_rgb_kernel(hsv.h, hsv.s, hsv.v);
+}
 
-    region    = h * 6 / 255;
-    remainder = (h * 2 - region * 85) * 3;
-
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
-
-    switch (region) {
-        case 6:
-        case 0:
-            rgb.r = v;
-            rgb.g = t;
-            rgb.b = p;
-            break;
-        case 1:
-            rgb.r = q;
-            rgb.g = v;
-            rgb.b = p;
-            break;
-        case 2:
-            rgb.r = p;
-            rgb.g = v;
-            rgb.b = t;
-            break;
-        case 3:
-            rgb.r = p;
-            rgb.g = q;
-            rgb.b = v;
-            break;
-        case 4:
-            rgb.r = t;
-            rgb.g = p;
-            rgb.b = v;
-            break;
-        default:
-            rgb.r = v;
-            rgb.g = p;
-            rgb.b = q;
-            break;
+void hsv_to_rgb_batch_impl(const HSV *hsv, RGB *rgb, uint8_t count, bool use_cie) {
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        for (uint8_t i = 0; i < count; i++) {
+            rgb[i] = hsv_to_rgb_kernel(hsv[i].h, hsv[i].s, pgm_read_byte(&CIE1931_CURVE[hsv[i].v]));
+        }
+        return;
+    }
+#endif
+    for (uint8_t i = 0; i < count; i++) {
+        rgb[i] = hsv_to_rgb_kernel(hsv[i].h, hsv[i].s, hsv[i].v);
     }
-
-    return rgb;
 }
 
 RGB hsv_to_rgb(HSV hsv) {
@@ -109,6 +99,14 @@ RGB hsv_to_rgb_nocie(HSV hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
 
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+#ifdef USE_CIE1931_CURVE
+    hsv_to_rgb_batch_impl(hsv, rgb, count, true);
+#else
+    hsv_to_rgb_batch_impl(hsv, rgb, count, false);
+#endif
+}
+
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led) {
     // Determine lowest value in all three colors, put that into
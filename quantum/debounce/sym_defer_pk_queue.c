@@ -0,0 +1,161 @@
+/*
+Copyright 2023 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Event driven symmetric per-key algorithm, with the same behaviour as sym_defer_pk.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+Only keys that are currently bouncing are tracked, in a queue ordered by expiry
+time, so the cost of a scan depends on the number of bouncing keys rather than
+on the size of the matrix. As every key waits for the same DEBOUNCE time, new
+keys always expire last and the queue never needs to be reordered.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef struct {
+    fast_timer_t expires;
+    uint8_t      row;
+    uint8_t      col;
+} debounce_event_t;
+
+#if DEBOUNCE > 0
+static debounce_event_t *debounce_events;
+static uint16_t          debounce_event_count;
+static matrix_row_t *    debounce_pending;
+
+static bool transfer_expired_events(matrix_row_t raw[], matrix_row_t cooked[], fast_timer_t now);
+static void update_debounce_events(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, fast_timer_t now);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    debounce_events      = (debounce_event_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_event_t));
+    debounce_pending     = (matrix_row_t *)malloc(num_rows * sizeof(matrix_row_t));
+    debounce_event_count = 0;
+    for (uint8_t r = 0; r < num_rows; r++) {
+        debounce_pending[r] = 0;
+    }
+}
+
+void debounce_free(void) {
+    free(debounce_events);
+    debounce_events = NULL;
+    free(debounce_pending);
+    debounce_pending = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+
+    if (debounce_event_count == 0 && !changed) {
+        return false;
+    }
+
+    fast_timer_t now = timer_read_fast();
+
+    if (debounce_event_count > 0) {
+        cooked_changed = transfer_expired_events(raw, cooked, now);
+    }
+
+    if (changed) {
+        update_debounce_events(raw, cooked, num_rows, now);
+    }
+
+    return cooked_changed;
+}
+
+static bool transfer_expired_events(matrix_row_t raw[], matrix_row_t cooked[], fast_timer_t now) {
+    bool     cooked_changed = false;
+    uint16_t expired        = 0;
+
+    while (expired < debounce_event_count && timer_expired_fast(now, debounce_events[expired].expires)) {
+        debounce_event_t *event    = &debounce_events[expired];
+        matrix_row_t      col_mask = ROW_SHIFTER << event->col;
+
+        matrix_row_t cooked_next = (cooked[event->row] & ~col_mask) | (raw[event->row] & col_mask);
+        cooked_changed |= cooked[event->row] ^ cooked_next;
+        cooked[event->row] = cooked_next;
+        debounce_pending[event->row] &= ~col_mask;
+        expired++;
+    }
+
+    if (expired > 0) {
+        debounce_event_count -= expired;
+        memmove(debounce_events, &debounce_events[expired], debounce_event_count * sizeof(debounce_event_t));
+    }
+
+    return cooked_changed;
+}
+
+static void cancel_debounce_event(uint8_t row, uint8_t col) {
+    for (uint16_t i = 0; i < debounce_event_count; i++) {
+        if (debounce_events[i].row == row && debounce_events[i].col == col) {
+            debounce_event_count--;
+            memmove(&debounce_events[i], &debounce_events[i + 1], (debounce_event_count - i) * sizeof(debounce_event_t));
+            return;
+        }
+    }
+}
+
+static void update_debounce_events(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, fast_timer_t now) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        // keys that changed again: start waiting for them to settle
+        matrix_row_t start = delta & ~debounce_pending[row];
+        // keys that bounced back to their debounced state: stop waiting
+        matrix_row_t cancel = debounce_pending[row] & ~delta;
+
+        for (uint8_t col = 0; cancel; col++, cancel >>= 1) {
+            if (cancel & 1) {
+                cancel_debounce_event(row, col);
+            }
+        }
+
+        for (uint8_t col = 0; start; col++, start >>= 1) {
+            if (start & 1) {
+                debounce_events[debounce_event_count++] = (debounce_event_t){
+                    .expires = now + DEBOUNCE,
+                    .row     = row,
+                    .col     = col,
+                };
+            }
+        }
+
+        debounce_pending[row] = delta;
+    }
+}
+
+#else
+#    include "none.c"
+#endif
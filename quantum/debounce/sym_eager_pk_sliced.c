@@ -0,0 +1,194 @@
+/*
+Copyright 2023 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Bit-sliced per-key algorithm, with the same behaviour as sym_eager_pk.
+After pressing a key, it immediately changes state, and sets a counter.
+No further inputs are accepted until DEBOUNCE milliseconds have occurred.
+The per-key counters are stored as bit planes, one matrix_row_t per counter bit,
+so a whole row of counters is updated with a handful of bitwise operations.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+// Number of bit planes needed to hold DEBOUNCE
+#if DEBOUNCE < 2
+#    define DEBOUNCE_BITS 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_BITS 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_BITS 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_BITS 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_BITS 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_BITS 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_BITS 7
+#else
+#    define DEBOUNCE_BITS 8
+#endif
+
+#if DEBOUNCE > 0
+static matrix_row_t *debounce_planes;
+static fast_timer_t  last_time;
+static bool          counters_need_update;
+static bool          matrix_need_update;
+static bool          cooked_changed;
+
+static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time);
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    debounce_planes = (matrix_row_t *)malloc(num_rows * DEBOUNCE_BITS * sizeof(matrix_row_t));
+    int i           = 0;
+    for (uint8_t r = 0; r < num_rows; r++) {
+        for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+            debounce_planes[i++] = 0;
+        }
+    }
+}
+
+void debounce_free(void) {
+    free(debounce_planes);
+    debounce_planes = NULL;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters(num_rows, elapsed_time);
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        transfer_matrix_values(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+// Subtracts elapsed_time from every running counter in the row, returns the counters that reached zero.
+static matrix_row_t count_down_row(matrix_row_t *planes, uint8_t elapsed_time) {
+    matrix_row_t running = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+        running |= planes[b];
+    }
+    if (!running) {
+        return 0;
+    }
+
+    matrix_row_t expired;
+    if (elapsed_time >> DEBOUNCE_BITS) {
+        expired = running;
+    } else {
+        // ripple borrow subtraction of the same value from all counters at once
+        matrix_row_t borrow    = 0;
+        matrix_row_t remaining = 0;
+        for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+            matrix_row_t subtrahend = (elapsed_time & (1 << b)) ? ~(matrix_row_t)0 : 0;
+            matrix_row_t plane      = planes[b];
+            planes[b]               = plane ^ subtrahend ^ borrow;
+            borrow                  = (~plane & (subtrahend | borrow)) | (subtrahend & borrow);
+            remaining |= planes[b];
+        }
+        // counter <= elapsed_time: either it underflowed or it hit exactly zero
+        expired = running & (borrow | ~remaining);
+    }
+
+    for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+        planes[b] &= running & ~expired;
+    }
+    if (running & ~expired) {
+        counters_need_update = true;
+    }
+    return expired;
+}
+
+// If the current time is > debounce counter, set the counter to enable input.
+static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    matrix_need_update   = false;
+    matrix_row_t *planes = debounce_planes;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        if (count_down_row(planes, elapsed_time)) {
+            matrix_need_update = true;
+        }
+        planes += DEBOUNCE_BITS;
+    }
+}
+
+// upload from raw_matrix to final matrix;
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    matrix_need_update   = false;
+    matrix_row_t *planes = debounce_planes;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta   = raw[row] ^ cooked[row];
+        matrix_row_t running = 0;
+        for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+            running |= planes[b];
+        }
+        // only keys without a running counter may change
+        matrix_row_t flip = delta & ~running;
+        if (flip) {
+            for (uint8_t b = 0; b < DEBOUNCE_BITS; b++) {
+                planes[b] |= (DEBOUNCE & (1 << b)) ? flip : 0;
+            }
+            counters_need_update = true;
+            cooked[row] ^= flip;
+            cooked_changed = true;
+        }
+        planes += DEBOUNCE_BITS;
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -0,0 +1,40 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+TEST_F(DebounceTest, ThreeKeysMiddleBouncing) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {}},
+        {1, {{0, 2, DOWN}}, {}},
+        {2, {{1, 3, DOWN}}, {}},
+        /* Bounce on the key in the middle of the queue */
+        {3, {{0, 2, UP}}, {}},
+        {4, {{0, 2, DOWN}}, {}},
+
+        {5, {}, {{0, 1, DOWN}}},
+        {7, {}, {{1, 3, DOWN}}},
+        {9, {}, {{0, 2, DOWN}}},
+
+        {20, {{0, 1, UP}, {0, 2, UP}, {1, 3, UP}}, {}},
+
+        {25, {}, {{0, 1, UP}, {0, 2, UP}, {1, 3, UP}}},
+    });
+    runEvents();
+}
@@ -2,7 +2,10 @@ TEST_LIST += \
 	debounce_none \
 	debounce_sym_defer_g \
 	debounce_sym_defer_pk \
+	debounce_sym_defer_pk_queue \
+	debounce_sym_defer_pk_sliced \
 	debounce_sym_defer_pr \
 	debounce_sym_eager_pk \
+	debounce_sym_eager_pk_sliced \
 	debounce_sym_eager_pr \
 	debounce_asym_eager_defer_pk
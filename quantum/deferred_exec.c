@@ -12,31 +12,133 @@
 //------------------------------------
 // Helpers
 //
+// Each table is used as a binary min-heap of executors ordered by trigger time, so that only the first one needs to be
+// checked by the background task. Executors stay in their slot for their whole lifetime, the heap is an array of slot
+// indices spread over the `heap_slot` fields of the table, with `heap_pos` mapping each slot back to its heap position.
+// Heap positions past the number of scheduled executors hold the free slots.
+//
 
-static deferred_token current_token = 0;
+// Tokens are 8-bit, which limits the number of usable slots in a table. Each slot needs at least two generations of
+// tokens, so that a token that has just been freed is never handed out again straight away.
+#define DEFERRED_EXEC_MAX_SLOTS 127
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
+#if MAX_DEFERRED_EXECUTORS > DEFERRED_EXEC_MAX_SLOTS
+#    error "MAX_DEFERRED_EXECUTORS must not be greater than 127"
+#endif
+
+static inline uint8_t table_slots(size_t table_count) {
+    return table_count > DEFERRED_EXEC_MAX_SLOTS ? DEFERRED_EXEC_MAX_SLOTS : table_count;
+}
+
+static inline bool trigger_before(uint32_t a, uint32_t b) {
+    return ((int32_t)TIMER_DIFF_32(a, b)) < 0;
+}
+
+static inline uint32_t heap_trigger_time(deferred_executor_t *table, uint8_t pos) {
+    return table[table[pos].heap_slot].trigger_time;
+}
+
+static inline void heap_init(deferred_executor_t *table, uint8_t slots) {
+    // Zero-initialised tables map every heap position to slot 0, which is only a valid permutation for a single slot.
+    if (slots > 1 && table[0].heap_slot == table[1].heap_slot) {
+        for (uint8_t i = 0; i < slots; ++i) {
+            table[i].heap_slot = i;
+            table[i].heap_pos  = i;
+        }
     }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
+}
+
+static inline uint8_t heap_count(deferred_executor_t *table, uint8_t slots) {
+    // Scheduled executors occupy the heap positions before the free slots, so the boundary can be bisected.
+    uint8_t lo = 0;
+    uint8_t hi = slots;
+    while (lo < hi) {
+        uint8_t mid = lo + (hi - lo) / 2;
+        if (table[table[mid].heap_slot].token != INVALID_DEFERRED_TOKEN) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return true;
+    return lo;
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static inline void heap_swap(deferred_executor_t *table, uint8_t a, uint8_t b) {
+    uint8_t slot_a         = table[a].heap_slot;
+    uint8_t slot_b         = table[b].heap_slot;
+    table[a].heap_slot     = slot_b;
+    table[b].heap_slot     = slot_a;
+    table[slot_a].heap_pos = b;
+    table[slot_b].heap_pos = a;
+}
+
+static void heap_sift_up(deferred_executor_t *table, uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!trigger_before(heap_trigger_time(table, pos), heap_trigger_time(table, parent))) {
+            break;
+        }
+        heap_swap(table, pos, parent);
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(deferred_executor_t *table, uint8_t count, uint8_t pos) {
+    while (true) {
+        uint16_t child = 2 * (uint16_t)pos + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && trigger_before(heap_trigger_time(table, child + 1), heap_trigger_time(table, child))) {
+            ++child;
+        }
+        if (!trigger_before(heap_trigger_time(table, child), heap_trigger_time(table, pos))) {
+            break;
         }
+        heap_swap(table, pos, child);
+        pos = child;
+    }
+}
+
+static void heap_update(deferred_executor_t *table, uint8_t count, uint8_t pos) {
+    if (pos > 0 && trigger_before(heap_trigger_time(table, pos), heap_trigger_time(table, (pos - 1) / 2))) {
+        heap_sift_up(table, pos);
+    } else {
+        heap_sift_down(table, count, pos);
+    }
+}
+
+static void heap_remove(deferred_executor_t *table, uint8_t count, uint8_t pos) {
+    uint8_t last = count - 1;
+    heap_swap(table, pos, last);
+
+    // Clear the table entry, which moves it into the free slots
+    deferred_executor_t *entry = &table[table[last].heap_slot];
+    entry->token               = INVALID_DEFERRED_TOKEN;
+    entry->trigger_time        = 0;
+    entry->callback            = NULL;
+    entry->cb_arg              = NULL;
+
+    if (pos < last) {
+        heap_update(table, last, pos);
+    }
+}
+
+static inline deferred_token allocate_token(deferred_executor_t *table, uint8_t slot, uint8_t slots) {
+    // The tokens of a slot are `slot + 1 + n * slots`. Each slot cycles through its own, so that a stale token only
+    // matches again once the same slot has been reused for all of its other generations.
+    uint8_t generations = (UINT8_MAX - 1 - slot) / slots + 1;
+    uint8_t generation  = table[slot].generation + 1;
+    if (generation >= generations) {
+        generation = 0;
     }
-    return current_token;
+    table[slot].generation = generation;
+    return slot + 1 + generation * slots;
+}
+
+static inline deferred_executor_t *find_entry(deferred_executor_t *table, uint8_t slots, deferred_token token) {
+    deferred_executor_t *entry = &table[(token - 1) % slots];
+    return entry->token == token ? entry : NULL;
 }
 
 //------------------------------------
@@ -49,27 +151,24 @@ deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_coun
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
+    uint8_t slots = table_slots(table_count);
+    heap_init(table, slots);
 
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
-        }
+    // Claim the first free slot, if any are available
+    uint8_t count = heap_count(table, slots);
+    if (count == slots) {
+        return INVALID_DEFERRED_TOKEN;
     }
 
-    // None available
-    return INVALID_DEFERRED_TOKEN;
+    // Set up the executor table entry
+    uint8_t              slot  = table[count].heap_slot;
+    deferred_executor_t *entry = &table[slot];
+    entry->token               = allocate_token(table, slot, slots);
+    entry->trigger_time        = timer_read32() + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    heap_sift_up(table, count);
+    return entry->token;
 }
 
 bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token, uint32_t delay_ms) {
@@ -79,17 +178,16 @@ bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    uint8_t              slots = table_slots(table_count);
+    deferred_executor_t *entry = find_entry(table, slots, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    heap_update(table, heap_count(table, slots), entry->heap_pos);
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
@@ -99,20 +197,15 @@ bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    uint8_t              slots = table_slots(table_count);
+    deferred_executor_t *entry = find_entry(table, slots, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, cancel and clear the table entry
+    heap_remove(table, heap_count(table, slots), entry->heap_pos);
+    return true;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
@@ -122,40 +215,65 @@ void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count,
     if (((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
         *last_execution_time = now;
 
-        // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
-            deferred_executor_t *entry      = &table[i];
+        uint8_t slots = table_slots(table_count);
+        if (!table || slots == 0) {
+            return;
+        }
+
+        // Run the executors in trigger order, stopping at the first one that isn't due yet
+        while (true) {
+            deferred_executor_t *entry      = &table[table[0].heap_slot];
             deferred_token       curr_token = entry->token;
 
-            // Check if we're supposed to execute this entry
-            if (curr_token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+            if (curr_token == INVALID_DEFERRED_TOKEN || ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+                break;
+            }
 
-                // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
-                if (entry->token != curr_token) {
-                    continue;
-                }
+            // Invoke the callback and work work out if we should be requeued
+            uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+
+            // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
+            if (entry->token != curr_token) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                entry->trigger_time += delay_ms;
 
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
+                // An executor that fell more than a whole delay behind would otherwise run again straight away, so it
+                // is picked up again on the next tick instead.
+                if (((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
+                    entry->trigger_time = now + 1;
                 }
+                heap_update(table, heap_count(table, slots), entry->heap_pos);
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                heap_remove(table, heap_count(table, slots), entry->heap_pos);
             }
         }
     }
 }
 
+uint32_t deferred_exec_advanced_next(deferred_executor_t *table, size_t table_count) {
+    if (!table || table_slots(table_count) == 0) {
+        return DEFERRED_EXEC_IDLE;
+    }
+
+    // The root of the heap is the executor due first, an empty heap has an unused slot at its root
+    deferred_executor_t *entry = &table[table[0].heap_slot];
+    if (entry->token == INVALID_DEFERRED_TOKEN) {
+        return DEFERRED_EXEC_IDLE;
+    }
+
+    int32_t remaining = (int32_t)TIMER_DIFF_32(entry->trigger_time, timer_read32());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
 //------------------------------------
 // Basic API: used by user-mode code, guaranteed to not collide with core deferred execution
 //
@@ -175,3 +293,6 @@ bool cancel_deferred_exec(deferred_token token) {
 void deferred_exec_task(void) {
     deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
 }
+uint32_t deferred_exec_next(void) {
+    return deferred_exec_advanced_next(basic_executors, MAX_DEFERRED_EXECUTORS);
+}
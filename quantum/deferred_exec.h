@@ -21,6 +21,11 @@ typedef uint8_t deferred_token;
  */
 #define INVALID_DEFERRED_TOKEN 0
 
+/**
+ * @def Value returned by deferred_exec_next() when no executor is scheduled.
+ */
+#define DEFERRED_EXEC_IDLE UINT32_MAX
+
 /**
  * @typedef Callback to execute.
  * @param trigger_time[in] the intended trigger time to execute the callback -- equivalent time-space as timer_read32()
@@ -65,6 +70,13 @@ bool cancel_deferred_exec(deferred_token token);
  */
 void deferred_exec_task(void);
 
+/**
+ * Number of milliseconds until the next deferred executor is due, for the main loop to know how long it may idle.
+ *
+ * @return 0 if an executor is due, or DEFERRED_EXEC_IDLE if none is scheduled
+ */
+uint32_t deferred_exec_next(void);
+
 //------------------------------------
 // Advanced API: used when a custom-allocated table is used, primarily for core code.
 //------------------------------------
@@ -73,9 +85,13 @@ void deferred_exec_task(void);
  * @struct Structure for containing self-hosted deferred executor tables.
  * @brief Core-side code can use this to create their own tables without impacting on the use of users' ability to add deferred execution.
  *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in an array.
+ *        Tables must be zero-initialised, and only the first 127 entries of a table are used.
  */
 typedef struct deferred_executor_t {
     deferred_token         token;
+    uint8_t                heap_slot;
+    uint8_t                heap_pos;
+    uint8_t                generation;
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
@@ -119,3 +135,12 @@ bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
  * @param last_execution_time[in,out] the last execution time -- this will be checked first to determine if execution is needed, and updated if execution occurred
  */
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time);
+
+/**
+ * Number of milliseconds until the next deferred executor in a custom table is due.
+ *
+ * @param table[in] the custom table used for storage
+ * @param table_count[in] the number of available items in the table
+ * @return 0 if an executor is due, or DEFERRED_EXEC_IDLE if none is scheduled
+ */
+uint32_t deferred_exec_advanced_next(deferred_executor_t *table, size_t table_count);
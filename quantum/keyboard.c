@@ -25,13 +25,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode.h"
 #include "timer.h"
 #include "sync_timer.h"
+#include "soft_timer.h"
 #include "print.h"
 #include "debug.h"
 #include "command.h"
 #include "util.h"
 #include "sendchar.h"
 #include "eeconfig.h"
+#include "action.h"
 #include "action_layer.h"
+#include "profiling.h"
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -104,6 +107,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef VIA_ENABLE
 #    include "via.h"
 #endif
+#ifdef SEND_STRING_ENABLE
+#    include "send_string.h"
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#    include "process_dynamic_macro.h"
+#endif
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
@@ -140,6 +149,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef OS_DETECTION_ENABLE
 #    include "os_detection.h"
 #endif
+#ifdef DEFERRED_EXEC_ENABLE
+#    include "deferred_exec.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -512,6 +524,12 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
  * internal QMK state machine.
  */
 static inline void generate_tick_event(void) {
+#ifdef TICKLESS_IDLE
+    // Without a tapping key or oneshot timeout in progress, ticks have no effect
+    if (!action_tick_pending()) {
+        return;
+    }
+#endif
     static uint16_t last_tick = 0;
     const uint16_t  now       = timer_read();
     if (TIMER_DIFF_16(now, last_tick) != 0) {
@@ -616,106 +634,322 @@ void quantum_task(void) {
     music_task();
 #endif
 
-#ifdef KEY_OVERRIDE_ENABLE
-    key_override_task();
-#endif
-
 #ifdef SEQUENCER_ENABLE
     sequencer_task();
 #endif
 
-#ifdef TAP_DANCE_ENABLE
-    tap_dance_task();
+    // Tap dance, combo, leader, auto shift, caps word, secure and key override timeouts
+    soft_timer_task();
+
+#ifdef WPM_ENABLE
+    decay_wpm();
 #endif
 
-#ifdef COMBO_ENABLE
-    combo_task();
+#ifdef DIP_SWITCH_ENABLE
+    dip_switch_task();
 #endif
+}
 
-#ifdef LEADER_ENABLE
-    leader_task();
+#ifdef TICKLESS_IDLE
+// Custom matrices cannot tell whether they are debouncing, their keyboard_idle_wait() has to account for it.
+__attribute__((weak)) bool matrix_is_debouncing(void) {
+    return false;
+}
+
+/** \brief Milliseconds until the firmware next has timed work to do
+ *
+ * Key presses, host traffic and other external events are not accounted for,
+ * keyboard_idle_wait() has to return early on any of them.
+ *
+ * \return 0 if the main loop has to run again straight away, or KEYBOARD_IDLE_FOREVER
+ *         if nothing is scheduled
+ */
+uint32_t keyboard_idle_time(void) {
+    // Tapping, oneshot and debounce timeouts are polled on every pass
+    if (action_tick_pending() || matrix_is_debouncing()) {
+        return 0;
+    }
+
+    // So are animations and anything else running continuously
+#    ifdef RGBLIGHT_ENABLE
+    if (rgblight_is_enabled()) {
+        return 0;
+    }
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    if (led_matrix_is_enabled()) {
+        return 0;
+    }
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    if (rgb_matrix_is_enabled()) {
+        return 0;
+    }
+#    endif
+#    ifdef AUDIO_ENABLE
+    if (audio_is_playing_note() || audio_is_playing_melody()) {
+        return 0;
+    }
+#    endif
+#    ifdef SEQUENCER_ENABLE
+    if (is_sequencer_on()) {
+        return 0;
+    }
+#    endif
+#    ifdef WPM_ENABLE
+    if (get_current_wpm() > 0) {
+        return 0;
+    }
+#    endif
+#    ifdef MOUSEKEY_ENABLE
+    report_mouse_t mouse_report = mousekey_get_report();
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) {
+        return 0;
+    }
+#    endif
+#    if defined(SEND_STRING_ENABLE) && defined(SEND_STRING_QUEUE_SIZE)
+    if (!send_string_queue_is_empty()) {
+        return 0;
+    }
+#    endif
+#    if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_ASYNC_PLAYBACK)
+    if (dynamic_macro_is_playing()) {
+        return 0;
+    }
+#    endif
+#    ifdef HOST_REPORT_COALESCE_INTERVAL
+    if (host_report_coalesce_pending()) {
+        return 0;
+    }
+#    endif
+#    ifdef SPLIT_KEYBOARD
+    // The master only sees the keys of the other half by polling the transport
+    if (is_keyboard_master()) {
+        return 0;
+    }
+#    endif
+#    if defined(POINTING_DEVICE_ENABLE) || defined(QUANTUM_PAINTER_ENABLE)
+    return 0;
+#    endif
+
+    // Feature timeouts and deferred executors know when they are due next
+    uint32_t idle_time = soft_timer_next();
+#    ifdef DEFERRED_EXEC_ENABLE
+    idle_time = MIN(idle_time, deferred_exec_next());
+#    endif
+    return idle_time;
+}
+
+/** \brief Waits for at most max_ms milliseconds, or until the next interrupt
+ *
+ * Keyboards override this to put the MCU to sleep between main loop passes.
+ * It has to return as soon as a key or anything else needing the main loop
+ * wakes the MCU up, the default returns straight away.
+ */
+__attribute__((weak)) void keyboard_idle_wait(uint32_t max_ms) {}
+
+void keyboard_idle_task(void) {
+    uint32_t idle_time = keyboard_idle_time();
+    if (idle_time > 0) {
+        keyboard_idle_wait(idle_time);
+    }
+}
+#endif // TICKLESS_IDLE
+
+#ifdef KEYBOARD_TASK_BUDGET
+#    ifndef KEYBOARD_TASK_MAX_DEFERRALS
+#        define KEYBOARD_TASK_MAX_DEFERRALS 8
+#    endif
+
+static keyboard_task_stats_t keyboard_task_stats = {.scan_interval_min = UINT16_MAX};
+static fast_timer_t          loop_start;
+static bool                  last_scan_valid = false;
+
+const keyboard_task_stats_t *keyboard_task_get_stats(void) {
+    return &keyboard_task_stats;
+}
+
+void keyboard_task_reset_stats(void) {
+    keyboard_task_stats = (keyboard_task_stats_t){.scan_interval_min = UINT16_MAX};
+    last_scan_valid     = false;
+}
+
+static void keyboard_task_loop_begin(void) {
+    fast_timer_t now = timer_read_fast();
+    if (last_scan_valid) {
+        fast_timer_t interval = TIMER_DIFF_FAST(now, loop_start);
+        if (interval > UINT16_MAX) {
+            interval = UINT16_MAX;
+        }
+        if (interval < keyboard_task_stats.scan_interval_min) {
+            keyboard_task_stats.scan_interval_min = interval;
+        }
+        if (interval > keyboard_task_stats.scan_interval_max) {
+            keyboard_task_stats.scan_interval_max = interval;
+        }
+    }
+    loop_start      = now;
+    last_scan_valid = true;
+    keyboard_task_stats.loops++;
+}
+
+static void keyboard_task_loop_end(void) {
+    fast_timer_t loop_time = timer_elapsed_fast(loop_start);
+    if (loop_time > keyboard_task_stats.loop_time_max) {
+        keyboard_task_stats.loop_time_max = loop_time > UINT16_MAX ? UINT16_MAX : loop_time;
+    }
+}
+#endif // KEYBOARD_TASK_BUDGET
+
+typedef struct {
+    void (*task)(void);
+#ifdef PROFILING_ENABLE
+    profiling_zone_t zone;
 #endif
+#ifdef KEYBOARD_TASK_BUDGET
+    uint8_t cost;     // duration of the last run, in milliseconds
+    uint8_t deferred; // number of consecutive loops this task has been skipped
+#endif
+} deferrable_task_t;
 
-#ifdef WPM_ENABLE
-    decay_wpm();
+#ifdef PROFILING_ENABLE
+#    define DEFERRABLE_TASK(fn) \
+        { .task = fn, .zone = {.name = #fn} }
+#else
+#    define DEFERRABLE_TASK(fn) \
+        { .task = fn }
 #endif
 
-#ifdef DIP_SWITCH_ENABLE
-    dip_switch_task();
+// Lighting and display tasks. Without KEYBOARD_TASK_BUDGET, they run at their
+// usual place in keyboard_task(). With it, they run once the matrix has been
+// scanned and reports have been sent, in order of priority, and are postponed
+// to a later loop if they would not fit in it.
+static deferrable_task_t lighting_tasks[] = {
+#if defined(RGBLIGHT_ENABLE)
+    DEFERRABLE_TASK(rgblight_task),
+#endif
+#ifdef LED_MATRIX_ENABLE
+    DEFERRABLE_TASK(led_matrix_task),
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    DEFERRABLE_TASK(rgb_matrix_task),
+#endif
+#if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    DEFERRABLE_TASK(backlight_task),
 #endif
+};
 
-#ifdef AUTO_SHIFT_ENABLE
-    autoshift_matrix_scan();
+static deferrable_task_t display_tasks[] = {
+#ifdef OLED_ENABLE
+    DEFERRABLE_TASK(oled_task),
 #endif
+#ifdef ST7565_ENABLE
+    DEFERRABLE_TASK(st7565_task),
+#endif
+};
 
-#ifdef CAPS_WORD_ENABLE
-    caps_word_task();
+static deferrable_task_t indicator_tasks[] = {
+    DEFERRABLE_TASK(led_task),
+};
+
+static void deferrable_task_run(deferrable_task_t *task) {
+#ifdef PROFILING_ENABLE
+    uint32_t start = PROFILING_TIMESTAMP();
+    task->task();
+    profiling_zone_record(&task->zone, PROFILING_ELAPSED(start));
+#else
+    task->task();
 #endif
+}
 
-#ifdef SECURE_ENABLE
-    secure_task();
+static void deferrable_tasks_run(deferrable_task_t *tasks, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        deferrable_task_t *task = &tasks[i];
+#ifdef KEYBOARD_TASK_BUDGET
+        fast_timer_t elapsed = timer_elapsed_fast(loop_start);
+        if (elapsed + task->cost >= KEYBOARD_TASK_BUDGET && task->deferred < KEYBOARD_TASK_MAX_DEFERRALS) {
+            task->deferred++;
+            keyboard_task_stats.deferrals++;
+            continue;
+        }
+        task->deferred = 0;
+        deferrable_task_run(task);
+        fast_timer_t cost = timer_elapsed_fast(loop_start) - elapsed;
+        task->cost        = cost > UINT8_MAX ? UINT8_MAX : cost;
+#else
+        deferrable_task_run(task);
 #endif
+    }
 }
 
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
     __attribute__((unused)) bool activity_has_occurred = false;
-    if (matrix_task()) {
+    bool                         matrix_changed;
+
+#ifdef KEYBOARD_TASK_BUDGET
+    keyboard_task_loop_begin();
+#endif
+
+#ifdef HOST_REPORT_COALESCE_INTERVAL
+    host_report_coalesce_task();
+#endif
+
+    // With KEYBOARD_TASK_BUDGET, input and report tasks run ahead of anything that can be deferred.
+    PROFILE_ZONE("matrix_task", matrix_changed = matrix_task());
+    if (matrix_changed) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
 
-    quantum_task();
+    PROFILE_ZONE("quantum_task", quantum_task());
 
 #if defined(SPLIT_WATCHDOG_ENABLE)
     split_watchdog_task();
 #endif
 
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
-#endif
-
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
-#endif
-
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
+#ifndef KEYBOARD_TASK_BUDGET
+    deferrable_tasks_run(lighting_tasks, ARRAY_SIZE(lighting_tasks));
 #endif
 
 #ifdef ENCODER_ENABLE
-    if (encoder_task()) {
+    bool encoder_changed;
+    PROFILE_ZONE("encoder_task", encoder_changed = encoder_task());
+    if (encoder_changed) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    if (pointing_device_task()) {
+    bool pointing_device_changed;
+    PROFILE_ZONE("pointing_device_task", pointing_device_changed = pointing_device_task());
+    if (pointing_device_changed) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
-#ifdef OLED_ENABLE
-    oled_task();
-#    if OLED_TIMEOUT > 0
+#ifndef KEYBOARD_TASK_BUDGET
+    deferrable_tasks_run(display_tasks, ARRAY_SIZE(display_tasks));
+#endif
+
+#if defined(OLED_ENABLE) && OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
-#    endif
 #endif
 
-#ifdef ST7565_ENABLE
-    st7565_task();
-#    if ST7565_TIMEOUT > 0
+#if defined(ST7565_ENABLE) && ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
-#    endif
+#endif
+
+#if defined(SEND_STRING_ENABLE) && defined(SEND_STRING_QUEUE_SIZE)
+    send_string_task();
+#endif
+
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_ASYNC_PLAYBACK)
+    dynamic_macro_task();
 #endif
 
 #ifdef MOUSEKEY_ENABLE
@@ -743,9 +977,21 @@ void keyboard_task(void) {
     haptic_task();
 #endif
 
-    led_task();
+#ifdef KEYBOARD_TASK_BUDGET
+    deferrable_tasks_run(lighting_tasks, ARRAY_SIZE(lighting_tasks));
+    deferrable_tasks_run(display_tasks, ARRAY_SIZE(display_tasks));
+#endif
+    deferrable_tasks_run(indicator_tasks, ARRAY_SIZE(indicator_tasks));
 
 #ifdef OS_DETECTION_ENABLE
     os_detection_task();
 #endif
+
+#ifdef KEYBOARD_TASK_BUDGET
+    keyboard_task_loop_end();
+#endif
+
+#ifdef PROFILING_ENABLE
+    profiling_task();
+#endif
 }
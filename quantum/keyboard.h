@@ -109,6 +109,30 @@ void keyboard_setup(void);
 void keyboard_init(void);
 /* it runs repeatedly in main loop */
 void keyboard_task(void);
+
+#ifdef KEYBOARD_TASK_BUDGET
+typedef struct {
+    uint32_t loops;             // number of keyboard_task() runs
+    uint32_t deferrals;         // number of times a lighting or display task was postponed
+    uint16_t loop_time_max;     // longest keyboard_task() run, in milliseconds
+    uint16_t scan_interval_min; // shortest time between two matrix scans, in milliseconds
+    uint16_t scan_interval_max; // longest time between two matrix scans, in milliseconds
+} keyboard_task_stats_t;
+
+/* scheduling statistics of keyboard_task, since startup or the last reset */
+const keyboard_task_stats_t *keyboard_task_get_stats(void);
+void                         keyboard_task_reset_stats(void);
+#endif
+#ifdef TICKLESS_IDLE
+#    define KEYBOARD_IDLE_FOREVER UINT32_MAX
+
+/* milliseconds until the main loop next has timed work to do */
+uint32_t keyboard_idle_time(void);
+/* sleeps until max_ms have passed or an interrupt occurs, to be overridden by the keyboard */
+void keyboard_idle_wait(uint32_t max_ms);
+/* it runs at the end of each main loop pass, and waits for keyboard_idle_time() */
+void keyboard_idle_task(void);
+#endif
 /* it runs whenever code has to behave differently on a slave */
 bool is_keyboard_master(void);
 /* it runs whenever code has to behave differently on left vs right split */
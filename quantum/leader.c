@@ -3,6 +3,7 @@
 
 #include "leader.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "util.h"
 
 #include <string.h>
@@ -17,6 +18,8 @@ uint16_t leader_time          = 0;
 uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
 uint8_t  leader_sequence_size = 0;
 
+static void leader_update_timer(void);
+
 __attribute__((weak)) void leader_start_user(void) {}
 
 __attribute__((weak)) void leader_end_user(void) {}
@@ -27,13 +30,14 @@ void leader_start(void) {
     }
     leader_start_user();
     leading              = true;
-    leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+    leader_reset_timer();
 }
 
 void leader_end(void) {
     leading = false;
+    soft_timer_stop(SOFT_TIMER_LEADER);
     leader_end_user();
 }
 
@@ -43,6 +47,18 @@ void leader_task(void) {
     }
 }
 
+// Wakes leader_task() up once the sequence times out.
+static void leader_update_timer(void) {
+#if defined(LEADER_NO_TIMEOUT)
+    if (leader_sequence_size == 0) {
+        soft_timer_stop(SOFT_TIMER_LEADER);
+        return;
+    }
+#endif
+    uint16_t elapsed = timer_elapsed(leader_time);
+    soft_timer_start(SOFT_TIMER_LEADER, elapsed > LEADER_TIMEOUT ? 0 : LEADER_TIMEOUT + 1 - elapsed, leader_task);
+}
+
 bool leader_sequence_active(void) {
     return leading;
 }
@@ -61,6 +77,13 @@ bool leader_sequence_add(uint16_t keycode) {
     leader_sequence[leader_sequence_size] = keycode;
     leader_sequence_size++;
 
+#if defined(LEADER_NO_TIMEOUT)
+    if (leader_sequence_size == 1) {
+        // The timeout only starts with the first key of the sequence.
+        leader_update_timer();
+    }
+#endif
+
     return true;
 }
 
@@ -74,6 +97,9 @@ bool leader_sequence_timed_out(void) {
 
 void leader_reset_timer(void) {
     leader_time = timer_read();
+    if (leading) {
+        leader_update_timer();
+    }
 }
 
 bool leader_sequence_is(uint16_t kc1, uint16_t kc2, uint16_t kc3, uint16_t kc4, uint16_t kc5) {
@@ -73,5 +73,10 @@ int main(void) {
 #endif // DEFERRED_EXEC_ENABLE
 
         housekeeping_task();
+
+#ifdef TICKLESS_IDLE
+        // Sleep until the next timeout, or until woken up by an interrupt
+        keyboard_idle_task();
+#endif
     }
 }
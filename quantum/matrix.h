@@ -53,6 +53,8 @@ void matrix_init(void);
 uint8_t matrix_scan(void);
 /* whether matrix scanning operations should be executed */
 bool matrix_can_read(void);
+/* whether the raw matrix has changes the debounced matrix does not reflect yet */
+bool matrix_is_debouncing(void);
 /* whether a switch is on */
 bool matrix_is_on(uint8_t row, uint8_t col);
 /* matrix state on row */
@@ -178,6 +178,19 @@ __attribute__((weak)) uint8_t matrix_scan(void) {
     return changed;
 }
 
+bool matrix_is_debouncing(void) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+#ifdef SPLIT_KEYBOARD
+        if (raw_matrix[row] != matrix[thisHand + row]) {
+#else
+        if (raw_matrix[row] != matrix[row]) {
+#endif
+            return true;
+        }
+    }
+    return false;
+}
+
 __attribute__((weak)) bool peek_matrix(uint8_t row_index, uint8_t col_index, bool raw) {
     return 0 != ((raw ? raw_matrix[row_index] : matrix[row_index]) & (MATRIX_ROW_SHIFTER << col_index));
 }
@@ -18,6 +18,7 @@
 #include "quantum.h"
 #include "action_util.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "keycodes.h"
 
 #ifndef AUTO_SHIFT_DISABLED_AT_STARTUP
@@ -321,6 +322,30 @@ void autoshift_matrix_scan(void) {
     }
 }
 
+static void autoshift_update_timer(void);
+
+static void autoshift_timer_callback(void) {
+    autoshift_matrix_scan();
+    // A per key timeout may have changed since the timer was started.
+    autoshift_update_timer();
+}
+
+// Wakes autoshift_matrix_scan() up once the pressed key reaches its timeout.
+static void autoshift_update_timer(void) {
+    if (autoshift_flags.in_progress) {
+        const uint16_t timeout =
+#ifdef AUTO_SHIFT_TIMEOUT_PER_KEY
+            get_autoshift_timeout(autoshift_lastkey, &autoshift_lastrecord);
+#else
+            autoshift_timeout;
+#endif
+        const uint16_t elapsed = TIMER_DIFF_16(timer_read(), autoshift_time);
+        soft_timer_start(SOFT_TIMER_AUTO_SHIFT, elapsed >= timeout ? 0 : timeout - elapsed, autoshift_timer_callback);
+    } else {
+        soft_timer_stop(SOFT_TIMER_AUTO_SHIFT);
+    }
+}
+
 void autoshift_toggle(void) {
     autoshift_flags.enabled = !autoshift_flags.enabled;
     autoshift_flush_shift();
@@ -361,9 +386,10 @@ __attribute__((weak)) uint16_t get_autoshift_timeout(uint16_t keycode, keyrecord
 
 void set_autoshift_timeout(uint16_t timeout) {
     autoshift_timeout = timeout;
+    autoshift_update_timer();
 }
 
-bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
+static bool process_auto_shift_event(uint16_t keycode, keyrecord_t *record) {
     // Note that record->event.time isn't reliable, see:
     // https://github.com/qmk/qmk_firmware/pull/9826#issuecomment-733559550
     // clang-format off
@@ -487,6 +513,12 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
+    bool result = process_auto_shift_event(keycode, record);
+    autoshift_update_timer();
+    return result;
+}
+
 #if defined(RETRO_SHIFT) && !defined(NO_ACTION_TAPPING)
 // Called to record time before possible delays by action_tapping_process.
 void retroshift_poll_time(keyevent_t *event) {
@@ -497,6 +529,7 @@ void retroshift_poll_time(keyevent_t *event) {
 void retroshift_swap_times(void) {
     if (autoshift_flags.in_progress) {
         autoshift_time = last_retroshift_time;
+        autoshift_update_timer();
     }
 }
 #endif
@@ -19,9 +19,232 @@
 #    include "autocorrect_data_default.h"
 #endif
 
+// Ring buffer of the last keycodes typed, oldest first from typo_buffer_start.
 static uint8_t typo_buffer[AUTOCORRECT_MAX_LENGTH] = {KC_SPC};
+static uint8_t typo_buffer_start                   = 0;
 static uint8_t typo_buffer_size                    = 1;
 
+static inline uint8_t typo_buffer_get(uint8_t i) {
+    return typo_buffer[(typo_buffer_start + i) % AUTOCORRECT_MAX_LENGTH];
+}
+
+static void typo_buffer_append(uint8_t keycode) {
+    // Drop the oldest keycode if buffer is full.
+    if (typo_buffer_size >= AUTOCORRECT_MAX_LENGTH) {
+        typo_buffer_start = (typo_buffer_start + 1) % AUTOCORRECT_MAX_LENGTH;
+        typo_buffer_size  = AUTOCORRECT_MAX_LENGTH - 1;
+    }
+    typo_buffer[(typo_buffer_start + typo_buffer_size) % AUTOCORRECT_MAX_LENGTH] = keycode;
+    typo_buffer_size++;
+}
+
+static inline uint16_t autocorrect_read_link(uint16_t offset) {
+    return pgm_read_byte(autocorrect_data + offset) | pgm_read_byte(autocorrect_data + offset + 1) << 8;
+}
+
+#ifdef AUTOCORRECT_AUTOMATON
+/* Position in the automaton after the keycodes of the buffer, the length of
+ * its failure link, and the buffer size they were computed for: if the buffer
+ * is shrunk or cleared, the position is recomputed from the buffer contents.
+ */
+static uint16_t autocorrect_state      = 0;
+static uint8_t  autocorrect_state_fail = 0;
+static uint8_t  autocorrect_state_size = 0;
+
+// The automaton stores keycodes in 5 bits, the word break and apostrophe take the codes after KC_Z.
+static inline uint8_t autocorrect_code(uint8_t keycode) {
+    switch (keycode) {
+        case KC_SPC:
+            return KC_Z + 1;
+        case KC_QUOTE:
+            return KC_Z + 2;
+        default:
+            return keycode;
+    }
+}
+
+/**
+ * @brief finds the child of a node
+ *
+ * @param state node
+ * @param fail failure link length of the node, updated to the child's
+ * @param code keycode of the child, as returned by autocorrect_code()
+ * @return the child, or 0 if there is none
+ */
+static uint16_t autocorrect_child(uint16_t state, uint8_t *fail, uint8_t code) {
+    uint8_t header = pgm_read_byte(autocorrect_data + state);
+    if (header & 128) {
+        return 0;
+    }
+
+    uint16_t next  = state + 1 + (((header >> 5) & 3) == 3);
+    uint16_t child = 0;
+    if (header & 31) {
+        // A single child follows the node.
+        if ((header & 31) == code) {
+            child = next;
+        }
+    } else {
+        // The first child follows the node, the others are linked.
+        uint8_t children = pgm_read_byte(autocorrect_data + next);
+        if (pgm_read_byte(autocorrect_data + next + 1) == code) {
+            child = next + 2 + 3 * (children - 1);
+        }
+        for (uint8_t i = 1; !child && i < children; ++i) {
+            uint16_t branch = next + 2 + 3 * (i - 1);
+            if (pgm_read_byte(autocorrect_data + branch) == code) {
+                child = autocorrect_read_link(branch + 1);
+            }
+        }
+    }
+
+    // Stop if `child` becomes an invalid index. This should not normally
+    // happen, it is a safeguard in case of a bug, data corruption, etc.
+    if (!child || child >= DICTIONARY_SIZE) {
+        return 0;
+    }
+
+    // The failure link of the child is one longer than its parent's, less the step stored in the child.
+    header = pgm_read_byte(autocorrect_data + child);
+    if (header & 128 || state == 0) {
+        *fail = 0;
+    } else {
+        uint8_t step = (header >> 5) & 3;
+        if (step == 3) {
+            step = pgm_read_byte(autocorrect_data + child + 1);
+        }
+        *fail = *fail + 1 - step;
+    }
+    return child;
+}
+
+/**
+ * @brief follows the transition of the automaton for the keycode at `end` in the buffer
+ *
+ * Looks for the keycode among the children of the node, following failure
+ * links towards the root until it is found. Only the length of a failure link
+ * is stored: as the node's letters are the last ones of the buffer before
+ * `end`, the node it leads to is found again by walking down from the root
+ * with as many of them.
+ *
+ * @param end index of the keycode in the buffer
+ */
+static void autocorrect_next_state(uint8_t end) {
+    uint8_t code = autocorrect_code(typo_buffer_get(end));
+    if (pgm_read_byte(autocorrect_data + autocorrect_state) & 128) {
+        // Restart from the root after a leaf.
+        autocorrect_state      = 0;
+        autocorrect_state_fail = 0;
+    }
+
+    while (true) {
+        uint8_t  fail  = autocorrect_state_fail;
+        uint16_t child = autocorrect_child(autocorrect_state, &fail, code);
+        if (child) {
+            autocorrect_state      = child;
+            autocorrect_state_fail = fail;
+            return;
+        }
+        if (autocorrect_state == 0) {
+            return;
+        }
+
+        // Follow the failure link.
+        uint8_t length         = autocorrect_state_fail < end ? autocorrect_state_fail : end;
+        autocorrect_state      = 0;
+        autocorrect_state_fail = 0;
+        for (uint8_t i = end - length; i < end; ++i) {
+            autocorrect_state = autocorrect_child(autocorrect_state, &autocorrect_state_fail, autocorrect_code(typo_buffer_get(i)));
+            if (!autocorrect_state) {
+                break;
+            }
+        }
+
+        // Every failure link leads to a shorter one, so this ends at the root.
+        // This is a safeguard in case of a bug, data corruption, etc.
+        if (!autocorrect_state || autocorrect_state_fail >= length) {
+            autocorrect_state      = 0;
+            autocorrect_state_fail = 0;
+        }
+    }
+}
+
+/**
+ * @brief appends `keycode` to the buffer and finds a typo ending with it
+ *
+ * @param keycode keycode typed
+ * @return offset of the leaf of the typo, or 0 if there is none
+ */
+static uint16_t autocorrect_find_typo(uint8_t keycode) {
+    // Recompute the position if the buffer was changed since the last keycode.
+    if (autocorrect_state_size != typo_buffer_size) {
+        autocorrect_state      = 0;
+        autocorrect_state_fail = 0;
+        for (uint8_t i = 0; i < typo_buffer_size; ++i) {
+            autocorrect_next_state(i);
+        }
+    }
+
+    typo_buffer_append(keycode);
+    autocorrect_next_state(typo_buffer_size - 1);
+    autocorrect_state_size = typo_buffer_size;
+
+    return (pgm_read_byte(autocorrect_data + autocorrect_state) & 128) ? autocorrect_state : 0;
+}
+#else
+/**
+ * @brief appends `keycode` to the buffer and finds a typo ending with it
+ *
+ * Dictionaries generated before the automaton format store a trie of the
+ * reversed typos, which is walked backwards from the end of the buffer.
+ *
+ * @param keycode keycode typed
+ * @return offset of the leaf of the typo, or 0 if there is none
+ */
+static uint16_t autocorrect_find_typo(uint8_t keycode) {
+    typo_buffer_append(keycode);
+
+    // Return if buffer is smaller than the shortest word.
+    if (typo_buffer_size < AUTOCORRECT_MIN_LENGTH) {
+        return 0;
+    }
+
+    // Check for typo in buffer using a trie stored in `autocorrect_data`.
+    uint16_t state = 0;
+    uint8_t  code  = pgm_read_byte(autocorrect_data + state);
+    for (int8_t i = typo_buffer_size - 1; i >= 0; --i) {
+        uint8_t const key_i = typo_buffer_get(i);
+
+        if (code & 64) { // Check for match in node with multiple children.
+            code &= 63;
+            for (; code != key_i; code = pgm_read_byte(autocorrect_data + (state += 3))) {
+                if (!code) return 0;
+            }
+            // Follow link to child node.
+            state = autocorrect_read_link(state + 1);
+            // Check for match in node with single child.
+        } else if (code != key_i) {
+            return 0;
+        } else if (!(code = pgm_read_byte(autocorrect_data + (++state)))) {
+            ++state;
+        }
+
+        // Stop if `state` becomes an invalid index. This should not normally
+        // happen, it is a safeguard in case of a bug, data corruption, etc.
+        if (state >= DICTIONARY_SIZE) {
+            return 0;
+        }
+
+        code = pgm_read_byte(autocorrect_data + state);
+
+        if (code & 128) { // A typo was found!
+            return state;
+        }
+    }
+    return 0;
+}
+#endif
+
 /**
  * @brief function for querying the enabled state of autocorrect
  *
@@ -265,110 +488,70 @@ bool process_autocorrect(uint16_t keycode, keyrecord_t *record) {
             return true;
     }
 
-    // Rotate oldest character if buffer is full.
-    if (typo_buffer_size >= AUTOCORRECT_MAX_LENGTH) {
-        memmove(typo_buffer, typo_buffer + 1, AUTOCORRECT_MAX_LENGTH - 1);
-        typo_buffer_size = AUTOCORRECT_MAX_LENGTH - 1;
-    }
-
-    // Append `keycode` to buffer.
-    typo_buffer[typo_buffer_size++] = keycode;
-    // Return if buffer is smaller than the shortest word.
-    if (typo_buffer_size < AUTOCORRECT_MIN_LENGTH) {
-        return true;
-    }
-
-    // Check for typo in buffer using a trie stored in `autocorrect_data`.
-    uint16_t state = 0;
-    uint8_t  code  = pgm_read_byte(autocorrect_data + state);
-    for (int8_t i = typo_buffer_size - 1; i >= 0; --i) {
-        uint8_t const key_i = typo_buffer[i];
-
-        if (code & 64) { // Check for match in node with multiple children.
-            code &= 63;
-            for (; code != key_i; code = pgm_read_byte(autocorrect_data + (state += 3))) {
-                if (!code) return true;
+    // Append `keycode` to buffer and check for a typo.
+    uint16_t state = autocorrect_find_typo(keycode);
+    if (state) { // A typo was found! Apply autocorrect.
+        const uint8_t backspaces = (pgm_read_byte(autocorrect_data + state) & 63) + !record->event.pressed;
+        const char *  changes    = (const char *)(autocorrect_data + state + 1);
+
+        /* Gather info about the typo'd word
+         *
+         * Since buffer may contain several words, delimited by spaces, we
+         * iterate from the end to find the start and length of the typo
+         */
+        char typo[AUTOCORRECT_MAX_LENGTH + 1] = {0}; // extra char for null terminator
+
+        uint8_t typo_len   = 0;
+        uint8_t typo_start = 0;
+        bool    space_last = typo_buffer_get(typo_buffer_size - 1) == KC_SPC;
+        for (uint8_t i = typo_buffer_size; i > 0; --i) {
+            // stop counting after finding space (unless it is the last thing)
+            if (typo_buffer_get(i - 1) == KC_SPC && i != typo_buffer_size) {
+                typo_start = i;
+                break;
             }
-            // Follow link to child node.
-            state = (pgm_read_byte(autocorrect_data + state + 1) | pgm_read_byte(autocorrect_data + state + 2) << 8);
-            // Check for match in node with single child.
-        } else if (code != key_i) {
-            return true;
-        } else if (!(code = pgm_read_byte(autocorrect_data + (++state)))) {
-            ++state;
-        }
 
-        // Stop if `state` becomes an invalid index. This should not normally
-        // happen, it is a safeguard in case of a bug, data corruption, etc.
-        if (state >= DICTIONARY_SIZE) {
-            return true;
+            ++typo_len;
         }
 
-        code = pgm_read_byte(autocorrect_data + state);
-
-        if (code & 128) { // A typo was found! Apply autocorrect.
-            const uint8_t backspaces = (code & 63) + !record->event.pressed;
-            const char *  changes    = (const char *)(autocorrect_data + state + 1);
-
-            /* Gather info about the typo'd word
-             *
-             * Since buffer may contain several words, delimited by spaces, we
-             * iterate from the end to find the start and length of the typo
-             */
-            char typo[AUTOCORRECT_MAX_LENGTH + 1] = {0}; // extra char for null terminator
-
-            uint8_t typo_len   = 0;
-            uint8_t typo_start = 0;
-            bool    space_last = typo_buffer[typo_buffer_size - 1] == KC_SPC;
-            for (uint8_t i = typo_buffer_size; i > 0; --i) {
-                // stop counting after finding space (unless it is the last thing)
-                if (typo_buffer[i - 1] == KC_SPC && i != typo_buffer_size) {
-                    typo_start = i;
-                    break;
-                }
-
-                ++typo_len;
-            }
-
-            // when detecting 'typo:', reduce the length of the string by one
-            if (space_last) {
-                --typo_len;
-            }
+        // when detecting 'typo:', reduce the length of the string by one
+        if (space_last) {
+            --typo_len;
+        }
 
-            // convert buffer of keycodes into a string
-            for (uint8_t i = 0; i < typo_len; ++i) {
-                typo[i] = typo_buffer[typo_start + i] - KC_A + 'a';
-            }
+        // convert buffer of keycodes into a string
+        for (uint8_t i = 0; i < typo_len; ++i) {
+            typo[i] = typo_buffer_get(typo_start + i) - KC_A + 'a';
+        }
 
-            /* Gather the corrected word
-             *
-             * A) Correction of 'typo:' -- Code takes into account
-             * an extra backspace to delete the space (which we dont copy)
-             * for this reason the offset is correct to "skip" the null terminator
-             *
-             * B) When correcting 'typo' -- Need extra offset for terminator
-             */
-            char correct[AUTOCORRECT_MAX_LENGTH + 10] = {0}; // let's hope this is big enough
-
-            uint8_t offset = space_last ? backspaces : backspaces + 1;
-            strcpy(correct, typo);
-            strcpy_P(correct + typo_len - offset, changes);
-
-            if (apply_autocorrect(backspaces, changes, typo, correct)) {
-                for (uint8_t i = 0; i < backspaces; ++i) {
-                    tap_code(KC_BSPC);
-                }
-                send_string_P(changes);
+        /* Gather the corrected word
+         *
+         * A) Correction of 'typo:' -- Code takes into account
+         * an extra backspace to delete the space (which we dont copy)
+         * for this reason the offset is correct to "skip" the null terminator
+         *
+         * B) When correcting 'typo' -- Need extra offset for terminator
+         */
+        char correct[AUTOCORRECT_MAX_LENGTH + 10] = {0}; // let's hope this is big enough
+
+        uint8_t offset = space_last ? backspaces : backspaces + 1;
+        strcpy(correct, typo);
+        strcpy_P(correct + typo_len - offset, changes);
+
+        if (apply_autocorrect(backspaces, changes, typo, correct)) {
+            for (uint8_t i = 0; i < backspaces; ++i) {
+                tap_code(KC_BSPC);
             }
+            send_string_P(changes);
+        }
 
-            if (keycode == KC_SPC) {
-                typo_buffer[0]   = KC_SPC;
-                typo_buffer_size = 1;
-                return true;
-            } else {
-                typo_buffer_size = 0;
-                return false;
-            }
+        if (keycode == KC_SPC) {
+            typo_buffer_size = 0;
+            typo_buffer_append(KC_SPC);
+            return true;
+        } else {
+            typo_buffer_size = 0;
+            return false;
         }
     }
     return true;
@@ -16,9 +16,11 @@
 
 #include "process_combo.h"
 #include <stddef.h>
+#include <string.h>
 #include "process_auto_shift.h"
 #include "caps_word.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "wait.h"
 #include "keyboard.h"
 #include "keymap_common.h"
@@ -77,6 +79,18 @@ static uint16_t timer = 0;
 static bool     b_combo_enable = true; // defaults to enabled
 static uint16_t longest_term   = 0;
 
+#ifndef COMBO_NO_TIMER
+// Wakes combo_task() up once the longest combo term has passed.
+static void combo_update_timer(void) {
+    if (timer) {
+        uint16_t elapsed = timer_elapsed(timer);
+        soft_timer_start(SOFT_TIMER_COMBO, elapsed > longest_term ? 0 : longest_term + 1 - elapsed, combo_task);
+    } else {
+        soft_timer_stop(SOFT_TIMER_COMBO);
+    }
+}
+#endif
+
 typedef struct {
     keyrecord_t record;
     uint16_t    combo_index;
@@ -94,6 +108,21 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_KEY_INDEX_LENGTH
+/* Inverted index from keycode to the combos containing it, sorted by keycode
+ * and then by combo index, so candidates are visited in keymap order. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_key_index_entry_t;
+static combo_key_index_entry_t combo_key_index[COMBO_KEY_INDEX_LENGTH];
+static uint16_t                combo_key_index_size  = 0;
+static bool                    combo_key_index_built = false;
+static bool                    combo_key_index_valid = false;
+/* Combos that may hold state since the last clear_combos(). */
+static uint8_t combo_key_index_dirty[(COMBO_KEY_INDEX_LENGTH + 7) / 8];
+#endif
+
 #ifndef EXTRA_SHORT_COMBOS
 /* flags are their own elements in combo_t struct. */
 #    define COMBO_ACTIVE(combo) (combo->active)
@@ -194,6 +223,26 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_KEY_INDEX_LENGTH
+    if (combo_key_index_built && combo_key_index_valid) {
+        for (uint16_t byte = 0; byte < sizeof(combo_key_index_dirty); ++byte) {
+            if (!combo_key_index_dirty[byte]) {
+                continue;
+            }
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                index = byte * 8 + bit;
+                if ((combo_key_index_dirty[byte] & (1 << bit)) && index < combo_count()) {
+                    combo_t *combo = combo_get(index);
+                    if (!COMBO_ACTIVE(combo)) {
+                        RESET_COMBO_STATE(combo);
+                    }
+                }
+            }
+            combo_key_index_dirty[byte] = 0;
+        }
+        return;
+    }
+#endif
     for (index = 0; index < combo_count(); ++index) {
         combo_t *combo = combo_get(index);
         if (!COMBO_ACTIVE(combo)) {
@@ -534,6 +583,71 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     return key_is_part_of_combo;
 }
 
+#ifdef COMBO_KEY_INDEX_LENGTH
+void combo_key_index_invalidate(void) {
+    combo_key_index_built = false;
+}
+
+static void combo_key_index_insert(uint16_t keycode, uint16_t combo_index) {
+    if (combo_key_index_size >= COMBO_KEY_INDEX_LENGTH) {
+        combo_key_index_valid = false;
+        return;
+    }
+    /* Entries arrive in ascending combo order, so shifting only past larger
+     * keycodes keeps equal keycodes sorted by combo index. */
+    uint16_t i = combo_key_index_size++;
+    while (i > 0 && combo_key_index[i - 1].keycode > keycode) {
+        combo_key_index[i] = combo_key_index[i - 1];
+        i--;
+    }
+    combo_key_index[i] = (combo_key_index_entry_t){
+        .keycode     = keycode,
+        .combo_index = combo_index,
+    };
+}
+
+static void combo_key_index_build(void) {
+    combo_key_index_size  = 0;
+    combo_key_index_valid = combo_count() <= COMBO_KEY_INDEX_LENGTH;
+    /* State left over from before the rebuild is unknown, clear everything once. */
+    memset(combo_key_index_dirty, 0xFF, sizeof(combo_key_index_dirty));
+    for (uint16_t idx = 0; idx < combo_count() && combo_key_index_valid; ++idx) {
+        combo_t *combo = combo_get(idx);
+        uint16_t key;
+        for (uint8_t key_i = 0; (key = pgm_read_word(&combo->keys[key_i])) != COMBO_END; ++key_i) {
+            /* A combo is only processed once per event, skip repeated keys. */
+            bool     repeated = false;
+            uint16_t other;
+            for (uint8_t other_i = 0; other_i < key_i; ++other_i) {
+                other = pgm_read_word(&combo->keys[other_i]);
+                if (other == key) {
+                    repeated = true;
+                    break;
+                }
+            }
+            if (!repeated) {
+                combo_key_index_insert(key, idx);
+            }
+        }
+    }
+    combo_key_index_built = true;
+}
+
+/* Returns the position of the first index entry for keycode. */
+static uint16_t combo_key_index_find(uint16_t keycode) {
+    uint16_t low = 0, high = combo_key_index_size;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_key_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
     bool is_combo_key          = false;
     bool no_combo_keys_pressed = true;
@@ -564,10 +678,26 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX_LENGTH
+    if (!combo_key_index_built) {
+        combo_key_index_build();
+    }
+    if (combo_key_index_valid) {
+        /* Only combos containing the keycode can be affected by this event. */
+        for (uint16_t i = combo_key_index_find(keycode); i < combo_key_index_size && combo_key_index[i].keycode == keycode; ++i) {
+            uint16_t idx   = combo_key_index[i].combo_index;
+            combo_t *combo = combo_get(idx);
+            combo_key_index_dirty[idx / 8] |= 1 << (idx % 8);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+            combo_t *combo = combo_get(idx);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -602,6 +732,9 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
             clear_combos();
         }
     }
+#ifndef COMBO_NO_TIMER
+    combo_update_timer();
+#endif
     return !is_combo_key;
 }
 
@@ -621,6 +754,7 @@ void combo_task(void) {
             timer = 0;
             clear_combos();
         }
+        combo_update_timer();
     }
 #endif
 }
@@ -632,6 +766,7 @@ void combo_enable(void) {
 void combo_disable(void) {
 #ifndef COMBO_NO_TIMER
     timer = 0;
+    combo_update_timer();
 #endif
     b_combo_enable    = false;
     combo_buffer_read = combo_buffer_write;
@@ -23,6 +23,22 @@
 #include "debug.h"
 #include "wait.h"
 
+#ifdef DYNAMIC_MACRO_ASYNC_PLAYBACK
+#    include "timer.h"
+#endif
+
+#if defined(DYNAMIC_MACRO_PLAYBACK_TIMING) && !defined(DYNAMIC_MACRO_ASYNC_PLAYBACK)
+#    error DYNAMIC_MACRO_PLAYBACK_TIMING requires DYNAMIC_MACRO_ASYNC_PLAYBACK
+#endif
+
+#ifndef DYNAMIC_MACRO_PLAYBACK_INTERVAL
+#    ifdef DYNAMIC_MACRO_DELAY
+#        define DYNAMIC_MACRO_PLAYBACK_INTERVAL DYNAMIC_MACRO_DELAY
+#    else
+#        define DYNAMIC_MACRO_PLAYBACK_INTERVAL 1
+#    endif
+#endif
+
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -106,13 +122,13 @@ void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_
 }
 
 /**
- * Play the dynamic macro.
+ * Play the dynamic macro in one go, blocking until it is done.
  *
  * @param macro_buffer[in] The beginning of the macro buffer being played.
  * @param macro_end[in]    The element after the last macro buffer element.
  * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+static void dynamic_macro_play_blocking(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
     layer_state_t saved_layer_state = layer_state;
@@ -135,6 +151,118 @@ void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_
     dynamic_macro_play_kb(direction);
 }
 
+#ifdef DYNAMIC_MACRO_ASYNC_PLAYBACK
+/* State of the macro being played back by dynamic_macro_task(), one
+ * event at a time. The pointer is NULL when no macro is playing. */
+static struct {
+    keyrecord_t * pointer;
+    keyrecord_t * end;
+    int8_t        direction;
+    layer_state_t saved_layer_state;
+    fast_timer_t  next;
+} playback = {0};
+
+/* Set while an event of the macro is being processed, so it is not
+ * mistaken for a key press interrupting the playback. */
+static bool playback_processing = false;
+
+bool dynamic_macro_is_playing(void) {
+    return playback.pointer != NULL;
+}
+
+static void dynamic_macro_playback_end(void) {
+    clear_keyboard();
+
+    layer_state_set(playback.saved_layer_state);
+
+    playback.pointer = NULL;
+}
+
+void dynamic_macro_stop_playback(void) {
+    if (dynamic_macro_is_playing()) {
+        dprintln("dynamic macro: playback interrupted");
+        dynamic_macro_playback_end();
+    }
+}
+
+/**
+ * Start playing the dynamic macro from dynamic_macro_task().
+ *
+ * A macro played from within another macro is played in one go.
+ *
+ * @param macro_buffer[in] The beginning of the macro buffer being played.
+ * @param macro_end[in]    The element after the last macro buffer element.
+ * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ */
+void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+    if (playback_processing) {
+        dynamic_macro_play_blocking(macro_buffer, macro_end, direction);
+        return;
+    }
+
+    dynamic_macro_stop_playback();
+
+    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+
+    playback.saved_layer_state = layer_state;
+
+    clear_keyboard();
+    layer_clear();
+
+    playback.pointer   = macro_buffer;
+    playback.end       = macro_end;
+    playback.direction = direction;
+    playback.next      = timer_read_fast();
+
+    if (macro_buffer == macro_end) {
+        dynamic_macro_playback_end();
+        dynamic_macro_play_kb(direction);
+    }
+}
+
+/**
+ * Play the next event of the current macro, if it is due.
+ */
+void dynamic_macro_task(void) {
+    if (!dynamic_macro_is_playing() || !timer_expired_fast(timer_read_fast(), playback.next)) {
+        return;
+    }
+
+    keyrecord_t *record = playback.pointer;
+
+    playback_processing = true;
+    process_record(record);
+    playback_processing = false;
+
+    // Stopped by the event itself, e.g. a recording being started
+    if (!dynamic_macro_is_playing()) {
+        return;
+    }
+
+    playback.pointer += playback.direction;
+    if (playback.pointer == playback.end) {
+        int8_t direction = playback.direction;
+        dynamic_macro_playback_end();
+        dynamic_macro_play_kb(direction);
+        return;
+    }
+
+    uint16_t interval = DYNAMIC_MACRO_PLAYBACK_INTERVAL;
+#    ifdef DYNAMIC_MACRO_PLAYBACK_TIMING
+    // Replay the time that elapsed between the two events while recording
+    uint16_t recorded = TIMER_DIFF_16(playback.pointer->event.time, record->event.time);
+    if (recorded > interval) {
+        interval = recorded;
+    }
+#    endif
+    playback.next = timer_read_fast() + interval;
+}
+#else
+void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+    dynamic_macro_play_blocking(macro_buffer, macro_end, direction);
+}
+#endif
+
 /**
  * Record a single key in a dynamic macro.
  *
@@ -247,6 +375,13 @@ void dynamic_macro_stop_recording(void) {
 /* Handle the key events related to the dynamic macros.
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
+#ifdef DYNAMIC_MACRO_ASYNC_PLAYBACK
+    /* Any key pressed during the playback interrupts it. */
+    if (record->event.pressed && !playback_processing) {
+        dynamic_macro_stop_playback();
+    }
+#endif
+
     if (macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
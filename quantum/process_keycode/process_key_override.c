@@ -18,6 +18,7 @@
 #include "process_key_override.h"
 #include "report.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "debug.h"
 #include "wait.h"
 #include "action_util.h"
@@ -84,6 +85,26 @@ static uint16_t deferred_register = 0;
 // TODO: in future maybe save in EEPROM?
 static bool enabled = true;
 
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+#    if KEY_OVERRIDE_INDEX_LENGTH > 255
+#        error "KEY_OVERRIDE_INDEX_LENGTH must not be greater than 255"
+#    endif
+
+/* Index of the key overrides by trigger keycode, sorted by trigger and then
+ * by override index, so candidates are visited in keymap order. An override
+ * can only activate if its trigger is KC_NO, the keycode of the event or the
+ * last key pressed down, so only those three groups need to be checked. */
+typedef struct {
+    uint16_t trigger;
+    uint8_t  trigger_mods;
+    uint8_t  override_index;
+} key_override_index_entry_t;
+static key_override_index_entry_t key_override_index[KEY_OVERRIDE_INDEX_LENGTH];
+static uint8_t                    key_override_index_size  = 0;
+static bool                       key_override_index_built = false;
+static bool                       key_override_index_valid = false;
+#endif
+
 // Forward decls
 static const key_override_t *clear_active_override(const bool allow_reregister);
 
@@ -155,6 +176,14 @@ static void schedule_deferred_register(const uint16_t keycode) {
         defer_delay          = 50; // 50ms
     }
     deferred_register = keycode;
+
+    uint32_t elapsed = timer_elapsed32(defer_reference_time);
+    soft_timer_start(SOFT_TIMER_KEY_OVERRIDE, elapsed < defer_delay ? defer_delay - elapsed : 0, key_override_task);
+}
+
+static void cancel_deferred_register(void) {
+    deferred_register = 0;
+    soft_timer_stop(SOFT_TIMER_KEY_OVERRIDE);
 }
 
 const key_override_t *clear_active_override(const bool allow_reregister) {
@@ -164,7 +193,7 @@ const key_override_t *clear_active_override(const bool allow_reregister) {
 
     key_override_printf("Deactivating override\n");
 
-    deferred_register = 0;
+    cancel_deferred_register();
 
     // Clear the suppressed mods
     clear_suppressed_override_mods();
@@ -243,150 +272,255 @@ static bool check_activation_event(const key_override_t *override, const bool ke
     }
 }
 
-/** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
-static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
-    if (key_override_count() == 0) {
-        return true;
+/** Checks whether the override should activate for this event, except for the fast modifier check done by the caller. */
+static bool should_activate_override(const key_override_t *const override, const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods) {
+    // Check layer
+    if ((override->layers & (1 << layer)) == 0) {
+        key_override_printf("Not activating override: Not set to activate on pressed layer\n");
+        return false;
     }
 
-    for (uint8_t i = 0; i < key_override_count(); i++) {
-        const key_override_t *const override = key_override_get(i);
-
-        // End of array
-        if (override == NULL) {
-            break;
-        }
-
-        // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that require mods to be down while no mods are down
-        if (active_mods == 0 && override->trigger_mods != 0) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
-        }
+    // Check allowed activation events
+    if (!check_activation_event(override, key_down, is_mod)) {
+        key_override_printf("Not activating override: Activation event not allowed\n");
+        return false;
+    }
 
-        // Check layer
-        if ((override->layers & (1 << layer)) == 0) {
-            key_override_printf("Not activating override: Not set to activate on pressed layer\n");
-            continue;
-        }
+    const bool is_trigger = override->trigger == keycode;
 
-        // Check allowed activation events
-        if (!check_activation_event(override, key_down, is_mod)) {
-            key_override_printf("Not activating override: Activation event not allowed\n");
-            continue;
-        }
+    // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
+    if (is_trigger && !key_down) {
+        key_override_printf("Not activating override: Trigger lifted\n");
+        return false;
+    }
 
-        const bool is_trigger = override->trigger == keycode;
+    // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
+    const bool no_trigger = override->trigger == KC_NO;
 
-        // Check if trigger lifted. This is a small optimization in order to skip the remaining checks
-        if (is_trigger && !key_down) {
-            key_override_printf("Not activating override: Trigger lifted\n");
-            continue;
-        }
+    // Check if aleady active
+    if (override == active_override) {
+        key_override_printf("Not activating override: Alerady actived\n");
+        return false;
+    }
 
-        // If the trigger is KC_NO it means 'no key', so only the required modifiers need to be down.
-        const bool no_trigger = override->trigger == KC_NO;
+    // Check if enabled
+    if (override->enabled != NULL && !((*(override->enabled) & 1))) {
+        key_override_printf("Not activating override: Not enabled\n");
+        return false;
+    }
 
-        // Check if aleady active
-        if (override == active_override) {
-            key_override_printf("Not activating override: Alerady actived\n");
-            continue;
-        }
+    // Check mods precisely
+    if (!key_override_matches_active_modifiers(override, active_mods)) {
+        key_override_printf("Not activating override: Modifiers don't match\n");
+        return false;
+    }
 
-        // Check if enabled
-        if (override->enabled != NULL && !((*(override->enabled) & 1))) {
-            key_override_printf("Not activating override: Not enabled\n");
-            continue;
-        }
+    // Check if trigger key is down.
+    const bool trigger_down = is_trigger && key_down;
 
-        // Check mods precisely
-        if (!key_override_matches_active_modifiers(override, active_mods)) {
-            key_override_printf("Not activating override: Modifiers don't match\n");
-            continue;
-        }
+    // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
+    // If no trigger key is required, yes.
+    // If the trigger was just pressed, yes.
+    // If the last non-mod key that was pressed down is the trigger key, yes.
+    bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
 
-        // Check if trigger key is down.
-        const bool trigger_down = is_trigger && key_down;
+    if (!should_activate) {
+        key_override_printf("Not activating override. Trigger not down\n");
+        return false;
+    }
 
-        // At this point, all requirements for activation are checked, except whether the trigger key is pressed. Now we check if the required trigger is down
-        // If no trigger key is required, yes.
-        // If the trigger was just pressed, yes.
-        // If the last non-mod key that was pressed down is the trigger key, yes.
-        bool should_activate = no_trigger || trigger_down || last_key_down == override->trigger;
+    return true;
+}
 
-        if (!should_activate) {
-            key_override_printf("Not activating override. Trigger not down\n");
-            continue;
-        }
+/** Activates the override. Returns true if the key action for `keycode` should be sent */
+static bool activate_override(const key_override_t *const override, const uint16_t keycode, const bool key_down, const bool is_mod, const uint8_t active_mods) {
+    const bool trigger_down = override->trigger == keycode && key_down;
+    const bool no_trigger   = override->trigger == KC_NO;
 
-        key_override_printf("Activating override\n");
+    key_override_printf("Activating override\n");
 
-        clear_active_override(false);
+    clear_active_override(false);
 
 #ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
-        // Send a dummy keycode before unregistering the modifier(s)
-        // so that suppressing the modifier(s) doesn't falsely get interpreted
-        // by the host OS as a tap of a modifier key.
-        // For example, unintended activations of the start menu on Windows when
-        // using a GUI+<kc> key override with suppressed mods.
-        neutralize_flashing_modifiers(active_mods);
+    // Send a dummy keycode before unregistering the modifier(s)
+    // so that suppressing the modifier(s) doesn't falsely get interpreted
+    // by the host OS as a tap of a modifier key.
+    // For example, unintended activations of the start menu on Windows when
+    // using a GUI+<kc> key override with suppressed mods.
+    neutralize_flashing_modifiers(active_mods);
 #endif
 
-        active_override                 = override;
-        active_override_trigger_is_down = true;
+    active_override                 = override;
+    active_override_trigger_is_down = true;
+
+    set_suppressed_override_mods(override->suppressed_mods);
+
+    if (!trigger_down && !no_trigger) {
+        // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
+        if (IS_BASIC_KEYCODE(override->trigger)) {
+            del_key(override->trigger);
+        } else {
+            unregister_code(override->trigger);
+        }
+    }
+
+    const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
+
+    bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
+                                mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
+
+    // Try firing the custom handler
+    if (override->custom_action != NULL) {
+        register_replacement &= override->custom_action(true, override->context);
+    }
 
-        set_suppressed_override_mods(override->suppressed_mods);
+    if (register_replacement) {
+        const uint8_t override_mods = extract_mod_bits(override->replacement);
+        set_weak_override_mods(override_mods);
 
-        if (!trigger_down && !no_trigger) {
-            // When activating a key override the trigger is is always unregistered. In the case where the key that newly pressed is not the trigger key, we have to explicitly remove the trigger key from the keyboard report. If the trigger was just pressed down we simply suppress the event which also has the effect of the trigger key not being registered in the keyboard report.
-            if (IS_BASIC_KEYCODE(override->trigger)) {
-                del_key(override->trigger);
+        // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
+        if (is_mod) {
+            key_override_printf("Deferring register replacement key\n");
+            schedule_deferred_register(mod_free_replacement);
+            send_keyboard_report();
+        } else {
+            if (IS_BASIC_KEYCODE(mod_free_replacement)) {
+                add_key(mod_free_replacement);
             } else {
-                unregister_code(override->trigger);
+                key_override_printf("NOT KEY 2\n");
+                send_keyboard_report();
+                // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
+                wait_ms(10);
+                register_code(mod_free_replacement);
             }
         }
+    } else {
+        // If not registering the replacement key send keyboard report to update the unregistered keys.
+        send_keyboard_report();
+    }
+
+    // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
+    return !trigger_down;
+}
 
-        const uint16_t mod_free_replacement = clear_mods_from(override->replacement);
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+void key_override_index_invalidate(void) {
+    key_override_index_built = false;
+}
 
-        bool register_replacement = mod_free_replacement != KC_NO &&   // KC_NO is never registered
-                                    mod_free_replacement < SAFE_RANGE; // Custom keycodes are never registered
+static void key_override_index_build(void) {
+    key_override_index_size  = 0;
+    key_override_index_valid = key_override_count() <= KEY_OVERRIDE_INDEX_LENGTH;
+    for (uint8_t i = 0; i < key_override_count() && key_override_index_valid; i++) {
+        const key_override_t *const override = key_override_get(i);
 
-        // Try firing the custom handler
-        if (override->custom_action != NULL) {
-            register_replacement &= override->custom_action(true, override->context);
+        // End of array
+        if (override == NULL) {
+            break;
         }
 
-        if (register_replacement) {
-            const uint8_t override_mods = extract_mod_bits(override->replacement);
-            set_weak_override_mods(override_mods);
+        /* Overrides arrive in ascending order, so shifting only past larger
+         * triggers keeps equal triggers sorted by override index. */
+        uint8_t j = key_override_index_size++;
+        while (j > 0 && key_override_index[j - 1].trigger > override->trigger) {
+            key_override_index[j] = key_override_index[j - 1];
+            j--;
+        }
+        key_override_index[j] = (key_override_index_entry_t){
+            .trigger        = override->trigger,
+            .trigger_mods   = override->trigger_mods,
+            .override_index = i,
+        };
+    }
+    key_override_index_built = true;
+}
 
-            // If this is a modifier event that activates the key override we _always_ defer the actual full activation of the override
-            if (is_mod) {
-                key_override_printf("Deferring register replacement key\n");
-                schedule_deferred_register(mod_free_replacement);
-                send_keyboard_report();
-            } else {
-                if (IS_BASIC_KEYCODE(mod_free_replacement)) {
-                    add_key(mod_free_replacement);
-                } else {
-                    key_override_printf("NOT KEY 2\n");
-                    send_keyboard_report();
-                    // On macOS there seems to be a race condition when it comes to the keyboard report and consumer keycodes. It seems the OS may recognize a consumer keycode before an updated keyboard report, even if the keyboard report is actually sent before the consumer key. I assume it is some sort of race condition because it happens infrequently and very irregularly. Waiting for about at least 10ms between sending the keyboard report and sending the consumer code has shown to fix this.
-                    wait_ms(10);
-                    register_code(mod_free_replacement);
-                }
-            }
+/* Returns the position of the first index entry for trigger. */
+static uint8_t key_override_index_find(uint16_t trigger) {
+    uint8_t low = 0, high = key_override_index_size;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (key_override_index[mid].trigger < trigger) {
+            low = mid + 1;
         } else {
-            // If not registering the replacement key send keyboard report to update the unregistered keys.
-            send_keyboard_report();
+            high = mid;
         }
+    }
+    return low;
+}
+#endif
 
-        *activated = true;
+/** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
+static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
+    *activated = false;
 
-        // If the trigger is down, suppress the event so that it does not get added to the keyboard report.
-        return !trigger_down;
+    if (key_override_count() == 0) {
+        return true;
     }
 
-    *activated = false;
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+    if (!key_override_index_built) {
+        key_override_index_build();
+    }
+    if (key_override_index_valid) {
+        // Candidates are the overrides triggered by no key, this key, or the last key pressed down, merged in keymap order.
+        const uint16_t triggers[] = {KC_NO, keycode, last_key_down};
+        uint8_t        next[ARRAY_SIZE(triggers)];
+        for (uint8_t t = 0; t < ARRAY_SIZE(triggers); t++) {
+            bool duplicate = false;
+            for (uint8_t u = 0; u < t; u++) {
+                duplicate |= triggers[u] == triggers[t];
+            }
+            next[t] = duplicate ? key_override_index_size : key_override_index_find(triggers[t]);
+        }
+
+        while (true) {
+            uint8_t best = ARRAY_SIZE(triggers);
+            for (uint8_t t = 0; t < ARRAY_SIZE(triggers); t++) {
+                if (next[t] < key_override_index_size && key_override_index[next[t]].trigger == triggers[t] && (best == ARRAY_SIZE(triggers) || key_override_index[next[t]].override_index < key_override_index[next[best]].override_index)) {
+                    best = t;
+                }
+            }
+            if (best == ARRAY_SIZE(triggers)) {
+                break;
+            }
+            const key_override_index_entry_t *entry = &key_override_index[next[best]++];
+
+            // At least one of the trigger modifiers must be down, whether the override requires one or all of them
+            if (entry->trigger_mods != 0 && (entry->trigger_mods & active_mods) == 0) {
+                key_override_printf("Not activating override: Modifiers don't match\n");
+                continue;
+            }
+
+            const key_override_t *const override = key_override_get(entry->override_index);
+            if (should_activate_override(override, keycode, layer, key_down, is_mod, active_mods)) {
+                *activated = true;
+                return activate_override(override, keycode, key_down, is_mod, active_mods);
+            }
+        }
+        return true;
+    }
+#endif
+
+    for (uint8_t i = 0; i < key_override_count(); i++) {
+        const key_override_t *const override = key_override_get(i);
+
+        // End of array
+        if (override == NULL) {
+            break;
+        }
+
+        // Fast, but not full mods check. Most key presses will not have any mods down, and most overrides will require mods. Hence here we filter overrides that require mods to be down while no mods are down
+        if (active_mods == 0 && override->trigger_mods != 0) {
+            key_override_printf("Not activating override: Modifiers don't match\n");
+            continue;
+        }
+
+        if (should_activate_override(override, keycode, layer, key_down, is_mod, active_mods)) {
+            *activated = true;
+            return activate_override(override, keycode, key_down, is_mod, active_mods);
+        }
+    }
 
     return true;
 }
@@ -458,7 +592,7 @@ bool process_key_override(const uint16_t keycode, const keyrecord_t *const recor
         if (key_down) {
             last_key_down      = keycode;
             last_key_down_time = timer_read32();
-            deferred_register  = 0;
+            cancel_deferred_register();
         }
 
         // The last key that was pressed was just released. No more keys are therefore sending input
@@ -466,7 +600,7 @@ bool process_key_override(const uint16_t keycode, const keyrecord_t *const recor
             last_key_down      = 0;
             last_key_down_time = 0;
             // We also cancel any deferred registers because, again, no keys are sending any input. Only the last key that is pressed creates an input – this key was just lifted.
-            deferred_register = 0;
+            cancel_deferred_register();
         }
     }
 
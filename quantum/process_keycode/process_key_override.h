@@ -102,9 +102,14 @@ bool key_override_is_enabled(void);
 /** Handling of key overrides and its implemented keycodes */
 bool process_key_override(const uint16_t keycode, const keyrecord_t *const record);
 
-/** Perform any deferred keys */
+/** Perform any deferred keys, called back by the soft timer service once they are due */
 void key_override_task(void);
 
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+/** Rebuilds the index of key overrides by trigger key on the next key event, call this if key_override_get() changes what it returns */
+void key_override_index_invalidate(void);
+#endif
+
 /**
  *  Preferrably use these macros to create key overrides. They fix many of the options to a standard setting that should satisfy most basic use-cases. Only directly create a key_override_t struct when you really need to.
  */
@@ -20,11 +20,70 @@
 #include "action_tapping.h"
 #include "action_util.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "wait.h"
 #include "keymap_introspection.h"
 
-static uint16_t active_td;
-static uint16_t last_tap_time;
+#ifndef TAP_DANCE_MAX_SIMULTANEOUS
+#    define TAP_DANCE_MAX_SIMULTANEOUS 1
+#endif
+
+#if TAP_DANCE_MAX_SIMULTANEOUS < 1 || TAP_DANCE_MAX_SIMULTANEOUS > 255
+#    error "TAP_DANCE_MAX_SIMULTANEOUS must be between 1 and 255"
+#endif
+
+typedef struct {
+    uint16_t keycode;
+    uint16_t deadline;
+} active_tap_dance_t;
+
+// Dances waiting for another tap, ordered by the time they time out.
+static active_tap_dance_t active_tds[TAP_DANCE_MAX_SIMULTANEOUS];
+static uint8_t            active_td_count;
+
+// Wakes tap_dance_task() up when the first dance times out.
+static void active_td_update_timer(void) {
+    if (active_td_count) {
+        int16_t remaining = (int16_t)(active_tds[0].deadline - timer_read());
+        soft_timer_start(SOFT_TIMER_TAP_DANCE, remaining > 0 ? remaining : 0, tap_dance_task);
+    } else {
+        soft_timer_stop(SOFT_TIMER_TAP_DANCE);
+    }
+}
+
+static uint8_t active_td_find(uint16_t keycode) {
+    uint8_t i = 0;
+    while (i < active_td_count && active_tds[i].keycode != keycode) {
+        i++;
+    }
+    return i;
+}
+
+static void active_td_remove(uint16_t keycode) {
+    uint8_t i = active_td_find(keycode);
+    if (i == active_td_count) return;
+
+    active_td_count--;
+    for (; i < active_td_count; i++) {
+        active_tds[i] = active_tds[i + 1];
+    }
+    active_td_update_timer();
+}
+
+// (Re)schedules the dance to time out once more than the tapping term has elapsed since now.
+static void active_td_schedule(uint16_t keycode) {
+    uint16_t deadline = timer_read() + GET_TAPPING_TERM(keycode, &(keyrecord_t){}) + 1;
+
+    active_td_remove(keycode);
+
+    uint8_t i = active_td_count++;
+    while (i > 0 && (int16_t)(active_tds[i - 1].deadline - deadline) > 0) {
+        active_tds[i] = active_tds[i - 1];
+        i--;
+    }
+    active_tds[i] = (active_tap_dance_t){.keycode = keycode, .deadline = deadline};
+    active_td_update_timer();
+}
 
 void tap_dance_pair_on_each_tap(tap_dance_state_t *state, void *user_data) {
     tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
@@ -120,24 +179,37 @@ static inline void process_tap_dance_action_on_dance_finished(tap_dance_action_t
         send_keyboard_report();
         _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_dance_finished);
     }
-    active_td = 0;
     if (!action->state.pressed) {
         // There will not be a key release event, so reset now.
         process_tap_dance_action_on_reset(action);
     }
 }
 
-bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
-    tap_dance_action_t *action;
-
-    if (!record->event.pressed) return false;
+static void process_tap_dance_interrupt(uint16_t active_keycode, uint16_t keycode) {
+    tap_dance_action_t *action = tap_dance_get(QK_TAP_DANCE_GET_INDEX(active_keycode));
 
-    if (!active_td || keycode == active_td) return false;
-
-    action                             = tap_dance_get(QK_TAP_DANCE_GET_INDEX(active_td));
+    active_td_remove(active_keycode);
     action->state.interrupted          = true;
     action->state.interrupting_keycode = keycode;
     process_tap_dance_action_on_dance_finished(action);
+}
+
+bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return false;
+
+    if (!active_td_count || active_td_find(keycode) < active_td_count) return false;
+
+    if (IS_QK_TAP_DANCE(keycode) && QK_TAP_DANCE_GET_INDEX(keycode) < tap_dance_count()) {
+        // Another tap dance key only interrupts the dance closest to timing out, and only if there is no room left
+        // for it to run alongside the active ones.
+        if (active_td_count < TAP_DANCE_MAX_SIMULTANEOUS) return false;
+
+        process_tap_dance_interrupt(active_tds[0].keycode, keycode);
+    } else {
+        while (active_td_count) {
+            process_tap_dance_interrupt(active_tds[0].keycode, keycode);
+        }
+    }
 
     // Tap dance actions can leave some weak mods active (e.g., if the tap dance is mapped to a keycode with
     // modifiers), but these weak mods should not affect the keypress which interrupted the tap dance.
@@ -164,16 +236,17 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
-                last_tap_time = timer_read();
                 process_tap_dance_action_on_each_tap(action);
-                active_td = action->state.finished ? 0 : keycode;
+                if (action->state.finished) {
+                    active_td_remove(keycode);
+                } else {
+                    active_td_schedule(keycode);
+                }
             } else {
                 process_tap_dance_action_on_each_release(action);
                 if (action->state.finished) {
                     process_tap_dance_action_on_reset(action);
-                    if (active_td == keycode) {
-                        active_td = 0;
-                    }
+                    active_td_remove(keycode);
                 }
             }
 
@@ -184,17 +257,24 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void tap_dance_task(void) {
-    tap_dance_action_t *action;
-
-    if (!active_td || timer_elapsed(last_tap_time) <= GET_TAPPING_TERM(active_td, &(keyrecord_t){})) return;
-
-    action = tap_dance_get(QK_TAP_DANCE_GET_INDEX(active_td));
-    if (!action->state.interrupted) {
-        process_tap_dance_action_on_dance_finished(action);
+    // Only the dance closest to timing out needs to be checked, the others are due later.
+    while (active_td_count && timer_expired(timer_read(), active_tds[0].deadline)) {
+        uint16_t            keycode = active_tds[0].keycode;
+        tap_dance_action_t *action  = tap_dance_get(QK_TAP_DANCE_GET_INDEX(keycode));
+
+        active_td_remove(keycode);
+        if (!action->state.interrupted) {
+            process_tap_dance_action_on_dance_finished(action);
+        }
     }
 }
 
 void reset_tap_dance(tap_dance_state_t *state) {
-    active_td = 0;
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (&tap_dance_get(QK_TAP_DANCE_GET_INDEX(active_tds[i].keycode))->state == state) {
+            active_td_remove(active_tds[i].keycode);
+            break;
+        }
+    }
     process_tap_dance_action_on_reset((tap_dance_action_t *)state);
 }
@@ -0,0 +1,179 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "profiling.h"
+#include "timer.h"
+#include "print.h"
+
+static profiling_zone_t *zones_head  = NULL;
+static profiling_zone_t *zones_tail  = NULL;
+static uint8_t           zones_count = 0;
+
+static void profiling_zone_clear(profiling_zone_t *zone) {
+    zone->count = 0;
+    zone->min   = UINT32_MAX;
+    zone->max   = 0;
+    zone->total = 0;
+    memset(zone->histogram, 0, sizeof(zone->histogram));
+}
+
+static void profiling_zone_register(profiling_zone_t *zone) {
+    profiling_zone_clear(zone);
+    zone->next       = NULL;
+    zone->registered = true;
+    if (zones_tail) {
+        zones_tail->next = zone;
+    } else {
+        zones_head = zone;
+    }
+    zones_tail = zone;
+    zones_count++;
+}
+
+// Bucket n holds samples in [2^n, 2^(n+1)), bucket 0 also holds 0, the last bucket everything above.
+static uint8_t profiling_histogram_bucket(uint32_t ticks) {
+    uint8_t bucket = 0;
+    while ((ticks >>= 1) && bucket < PROFILING_HISTOGRAM_BUCKETS - 1) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void profiling_zone_record(profiling_zone_t *zone, uint32_t ticks) {
+    if (!zone->registered) {
+        profiling_zone_register(zone);
+    }
+
+    zone->count++;
+    zone->total += ticks;
+    if (ticks < zone->min) {
+        zone->min = ticks;
+    }
+    if (ticks > zone->max) {
+        zone->max = ticks;
+    }
+    zone->histogram[profiling_histogram_bucket(ticks)]++;
+}
+
+uint32_t profiling_zone_average(const profiling_zone_t *zone) {
+    if (zone->count == 0) {
+        return 0;
+    }
+    return (uint32_t)(zone->total / zone->count);
+}
+
+uint8_t profiling_zone_count(void) {
+    return zones_count;
+}
+
+profiling_zone_t *profiling_zone_get(uint8_t index) {
+    profiling_zone_t *zone = zones_head;
+    while (zone && index--) {
+        zone = zone->next;
+    }
+    return zone;
+}
+
+profiling_zone_t *profiling_zone_find(const char *name) {
+    for (profiling_zone_t *zone = zones_head; zone; zone = zone->next) {
+        if (strcmp(zone->name, name) == 0) {
+            return zone;
+        }
+    }
+    return NULL;
+}
+
+void profiling_reset(void) {
+    for (profiling_zone_t *zone = zones_head; zone; zone = zone->next) {
+        profiling_zone_clear(zone);
+    }
+}
+
+void profiling_print(void) {
+    for (profiling_zone_t *zone = zones_head; zone; zone = zone->next) {
+        if (zone->count == 0) {
+            uprintf("%s -- no samples\n", zone->name);
+            continue;
+        }
+        uprintf("%s -- count: %lu, min: %lu, avg: %lu, max: %lu\n", zone->name, (unsigned long)zone->count, (unsigned long)zone->min, (unsigned long)profiling_zone_average(zone), (unsigned long)zone->max);
+        uprintf("%s -- histogram:", zone->name);
+        for (uint8_t i = 0; i < PROFILING_HISTOGRAM_BUCKETS; i++) {
+            uprintf(" %lu", (unsigned long)zone->histogram[i]);
+        }
+        uprintf("\n");
+    }
+}
+
+static uint8_t pack_u32(uint8_t *data, uint32_t value) {
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = (value >> 16) & 0xFF;
+    data[3] = (value >> 24) & 0xFF;
+    return 4;
+}
+
+uint8_t profiling_zone_pack(uint8_t index, uint8_t *data, uint8_t length) {
+    profiling_zone_t *zone = profiling_zone_get(index);
+    if (!zone || length < 4 * sizeof(uint32_t)) {
+        return 0;
+    }
+
+    uint8_t offset = 0;
+    offset += pack_u32(&data[offset], zone->count);
+    offset += pack_u32(&data[offset], zone->count ? zone->min : 0);
+    offset += pack_u32(&data[offset], zone->max);
+    offset += pack_u32(&data[offset], profiling_zone_average(zone));
+
+    for (uint8_t i = 0; i < PROFILING_HISTOGRAM_BUCKETS && offset + sizeof(uint16_t) <= length; i++) {
+        uint16_t bucket = zone->histogram[i] > UINT16_MAX ? UINT16_MAX : zone->histogram[i];
+        data[offset++]  = bucket & 0xFF;
+        data[offset++]  = bucket >> 8;
+    }
+    return offset;
+}
+
+void profiling_task(void) {
+#if defined(PROFILING_PRINT_INTERVAL) && PROFILING_PRINT_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= PROFILING_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        profiling_print();
+        profiling_reset();
+    }
+#endif
+}
+
+#ifdef PROFILING_LATENCY_TRACE
+static profiling_zone_t    latency_exec_zone    = {.name = "scan_to_exec"};
+static profiling_zone_t    latency_process_zone = {.name = "scan_to_process"};
+static profiling_zone_t    latency_report_zone  = {.name = "scan_to_report"};
+static profiling_latency_t latency_current      = {0};
+
+static uint16_t latency_since(uint16_t event_time) {
+    return TIMER_DIFF_16(timer_read(), event_time);
+}
+
+void profiling_latency_exec(uint16_t event_time) {
+    profiling_zone_record(&latency_exec_zone, latency_since(event_time));
+}
+
+profiling_latency_t profiling_latency_process_begin(uint16_t event_time) {
+    profiling_latency_t previous = latency_current;
+    latency_current              = (profiling_latency_t){.event_time = event_time, .pending = true};
+    profiling_zone_record(&latency_process_zone, latency_since(event_time));
+    return previous;
+}
+
+void profiling_latency_process_end(profiling_latency_t previous) {
+    latency_current = previous;
+}
+
+void profiling_latency_report_sent(void) {
+    // Only the first report sent for an event counts towards its latency.
+    if (latency_current.pending) {
+        latency_current.pending = false;
+        profiling_zone_record(&latency_report_zone, latency_since(latency_current.event_time));
+    }
+}
+#endif // PROFILING_LATENCY_TRACE
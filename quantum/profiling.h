@@ -0,0 +1,158 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+    Named profiling zones, collecting min/max/average and a log2 histogram of
+    the time spent in a block of code, measured in timestamp ticks (CPU cycles
+    on ChibiOS, timer0 ticks on AVR, nanoseconds on the test platform).
+
+    Usage example:
+
+        #include "profiling.h"
+
+        // Original code:
+        matrix_task();
+
+        // Wrapped in a zone, registered on first use:
+        PROFILE_ZONE("matrix_task", matrix_task());
+
+    Zones can be dumped over console with `profiling_print()`, or packed into
+    raw HID reports with `profiling_zone_pack()`. Without `PROFILING_ENABLE`
+    the wrapped code is executed as-is.
+
+    With `PROFILING_LATENCY_TRACE` defined, the time from the detection of a
+    key event in the matrix scan to `action_exec()`, to `process_record()`
+    (after tapping and combo buffering), and to the first keyboard report sent
+    while processing it, is recorded in milliseconds in the "scan_to_exec",
+    "scan_to_process" and "scan_to_report" zones.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(PROTOCOL_LUFA) || defined(PROTOCOL_VUSB)
+#    include <avr/io.h>
+#    define PROFILING_TIMESTAMP() ((uint32_t)TCNT0)
+// timer0 is an 8-bit counter, spans are measured modulo 256 ticks
+#    define PROFILING_ELAPSED(start) ((uint8_t)(PROFILING_TIMESTAMP() - (start)))
+#elif defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    define PROFILING_TIMESTAMP() ((uint32_t)chSysGetRealtimeCounterX())
+#else
+// Other platforms, including the unit tests, provide their own timestamp source.
+uint32_t profiling_timestamp(void);
+#    define PROFILING_TIMESTAMP() profiling_timestamp()
+#endif
+
+#ifndef PROFILING_ELAPSED
+#    define PROFILING_ELAPSED(start) ((uint32_t)(PROFILING_TIMESTAMP() - (start)))
+#endif
+
+#if defined(PROFILING_LATENCY_TRACE) && !defined(PROFILING_ENABLE)
+#    error PROFILING_LATENCY_TRACE requires PROFILING_ENABLE = yes
+#endif
+
+#ifndef PROFILING_HISTOGRAM_BUCKETS
+#    define PROFILING_HISTOGRAM_BUCKETS 16
+#endif
+
+typedef struct profiling_zone_t {
+    const char *             name;
+    struct profiling_zone_t *next;
+    bool                     registered;
+    uint32_t                 count;
+    uint32_t                 min;
+    uint32_t                 max;
+    uint64_t                 total;
+    uint32_t                 histogram[PROFILING_HISTOGRAM_BUCKETS];
+} profiling_zone_t;
+
+#ifdef PROFILING_ENABLE
+
+#    define PROFILE_ZONE(zone_name, call)                                                \
+        do {                                                                             \
+            static profiling_zone_t profile_zone  = {.name = (zone_name)};               \
+            uint32_t                profile_start = PROFILING_TIMESTAMP();               \
+            do {                                                                         \
+                call;                                                                    \
+            } while (0);                                                                 \
+            profiling_zone_record(&profile_zone, PROFILING_ELAPSED(profile_start));      \
+        } while (0)
+
+#else
+
+#    define PROFILE_ZONE(zone_name, call) \
+        do {                              \
+            call;                         \
+        } while (0)
+
+#endif // PROFILING_ENABLE
+
+/**
+ * \brief Adds a sample to the zone, registering it on first use.
+ *
+ * \param zone the zone to update
+ * \param ticks elapsed time of the sample, in timestamp ticks
+ */
+void profiling_zone_record(profiling_zone_t *zone, uint32_t ticks);
+
+/**
+ * \brief Average of all samples recorded in the zone, or 0 if there are none.
+ */
+uint32_t profiling_zone_average(const profiling_zone_t *zone);
+
+/**
+ * \brief Number of zones currently registered.
+ */
+uint8_t profiling_zone_count(void);
+
+/**
+ * \brief Gets a registered zone by index, in order of registration.
+ *
+ * \return the zone, or NULL if index is out of range
+ */
+profiling_zone_t *profiling_zone_get(uint8_t index);
+
+/**
+ * \brief Finds a registered zone by name.
+ *
+ * \return the zone, or NULL if no zone of that name has been registered
+ */
+profiling_zone_t *profiling_zone_find(const char *name);
+
+/**
+ * \brief Clears the statistics of all registered zones, keeping them registered.
+ */
+void profiling_reset(void);
+
+/**
+ * \brief Prints the statistics of all registered zones over console.
+ */
+void profiling_print(void);
+
+/**
+ * \brief Packs the statistics of a zone into a buffer, e.g. a raw HID report.
+ *
+ * The layout is little endian: count, min, max and average as uint32_t,
+ * followed by as many uint16_t histogram buckets (saturated) as fit in the
+ * buffer.
+ *
+ * \return number of bytes written, or 0 if the zone does not exist or the
+ *         buffer is too small
+ */
+uint8_t profiling_zone_pack(uint8_t index, uint8_t *data, uint8_t length);
+
+void profiling_task(void);
+
+#ifdef PROFILING_LATENCY_TRACE
+typedef struct {
+    uint16_t event_time;
+    bool     pending;
+} profiling_latency_t;
+
+void                profiling_latency_exec(uint16_t event_time);
+profiling_latency_t profiling_latency_process_begin(uint16_t event_time);
+void                profiling_latency_process_end(profiling_latency_t previous);
+void                profiling_latency_report_sent(void);
+#endif
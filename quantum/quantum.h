@@ -44,6 +44,7 @@
 #include "bootloader.h"
 #include "timer.h"
 #include "sync_timer.h"
+#include "soft_timer.h"
 #include "gpio.h"
 #include "atomic_util.h"
 #include "host.h"
@@ -240,6 +241,10 @@ extern layer_state_t layer_state;
 #    include "os_detection.h"
 #endif
 
+#ifdef PROFILING_ENABLE
+#    include "profiling.h"
+#endif
+
 void set_single_persistent_default_layer(uint8_t default_layer);
 
 #define IS_LAYER_ON(layer) layer_state_is(layer)
@@ -259,6 +264,18 @@ bool     process_record_user(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_kb(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_user(uint16_t keycode, keyrecord_t *record);
 
+/* Handlers called by process_record_quantum(), in order, for keycodes within
+ * [first, last]. Handlers that need to see every key use the full range.
+ */
+typedef struct {
+    uint16_t first;
+    uint16_t last;
+    bool (*handler)(uint16_t keycode, keyrecord_t *record);
+} process_record_dispatch_t;
+
+uint8_t                   process_record_dispatch_count(void);
+process_record_dispatch_t process_record_dispatch_get(uint8_t index);
+
 void reset_keyboard(void);
 void soft_reset_keyboard(void);
 
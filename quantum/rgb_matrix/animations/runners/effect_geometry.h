@@ -0,0 +1,30 @@
+#pragma once
+
+// Position of LED i relative to k_rgb_matrix_center. With RGB_MATRIX_GEOMETRY_CACHE, the distance and angle are
+// computed once by rgb_matrix_init() rather than for every LED of every frame.
+
+static inline int16_t rgb_matrix_led_dx(uint8_t i) {
+    return g_led_config.point[i].x - k_rgb_matrix_center.x;
+}
+
+static inline int16_t rgb_matrix_led_dy(uint8_t i) {
+    return g_led_config.point[i].y - k_rgb_matrix_center.y;
+}
+
+static inline uint8_t rgb_matrix_led_dist(uint8_t i) {
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    return g_rgb_geometry[i].dist;
+#else
+    int16_t dx = rgb_matrix_led_dx(i);
+    int16_t dy = rgb_matrix_led_dy(i);
+    return sqrt16(dx * dx + dy * dy);
+#endif
+}
+
+static inline uint8_t rgb_matrix_led_angle(uint8_t i) {
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    return g_rgb_geometry[i].angle;
+#else
+    return atan2_8(rgb_matrix_led_dy(i), rgb_matrix_led_dx(i));
+#endif
+}
@@ -35,10 +35,26 @@ const led_point_t k_rgb_matrix_center = {112, 32};
 const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
+// Set once the default rgb_matrix_hsv_to_rgb() runs, i.e. it isn't overridden
+static bool rgb_matrix_hsv_to_rgb_is_default = false;
+
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+    rgb_matrix_hsv_to_rgb_is_default = true;
     return hsv_to_rgb(hsv);
 }
 
+// Used by the effect runners. Colors go through rgb_matrix_hsv_to_rgb() until it
+// turns out not to be overridden, and are converted in one go from then on.
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    if (!rgb_matrix_hsv_to_rgb_is_default) {
+        for (uint8_t i = 0; i < count; i++) {
+            rgb[i] = rgb_matrix_hsv_to_rgb(hsv[i]);
+        }
+        return;
+    }
+    hsv_to_rgb_batch(hsv, rgb, count);
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -69,6 +85,9 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+led_geometry_t g_rgb_geometry[RGB_MATRIX_LED_COUNT];
+#endif // RGB_MATRIX_GEOMETRY_CACHE
 
 // internals
 static bool            suspend_state     = false;
@@ -80,7 +99,7 @@ static rgb_task_states rgb_task_state    = SYNCING;
 // double buffers
 static uint32_t rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-static last_hit_t last_hit_buffer;
+static last_hit_ring_t last_hit_buffer;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 // split rgb matrix
@@ -88,6 +107,21 @@ static last_hit_t last_hit_buffer;
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
 
+// render slicing
+#if defined(RGB_MATRIX_LED_PROCESS_ADAPTIVE)
+#    define RGB_MATRIX_LED_PROCESS_SLICE rgb_process_limit
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#    define RGB_MATRIX_LED_PROCESS_SLICE RGB_MATRIX_LED_PROCESS_LIMIT
+#endif
+
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+// starts from the configured limit, then follows the measured cost of rendering
+static uint8_t      rgb_process_limit  = RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT ? RGB_MATRIX_LED_PROCESS_LIMIT : RGB_MATRIX_LED_COUNT;
+static uint32_t     rgb_process_leds   = 0; // LEDs rendered in the current window
+static uint32_t     rgb_process_time   = 0; // summed duration of the slices in the current window, in milliseconds
+static fast_timer_t rgb_process_window = 0;
+#endif // RGB_MATRIX_LED_PROCESS_ADAPTIVE
+
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, EECONFIG_RGB_MATRIX, rgb_matrix_config);
 
 void eeconfig_update_rgb_matrix(void) {
@@ -174,21 +208,13 @@ void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed) {
         led_count = rgb_matrix_map_row_column_to_led(row, col, led);
     }
 
-    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2); // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
-    }
-
+    // once full, each hit overwrites the oldest one
     for (uint8_t i = 0; i < led_count; i++) {
-        uint8_t index                = last_hit_buffer.count;
-        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
-        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
-        last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
-        last_hit_buffer.count++;
+        uint8_t slot                = last_hit_buffer.head;
+        last_hit_buffer.index[slot] = led[i];
+        last_hit_buffer.time[slot]  = rgb_timer_buffer;
+        last_hit_buffer.head        = slot + 1 < LED_HITS_TO_REMEMBER ? slot + 1 : 0;
+        if (last_hit_buffer.count < LED_HITS_TO_REMEMBER) last_hit_buffer.count++;
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
@@ -239,25 +265,78 @@ static bool rgb_matrix_none(effect_params_t *params) {
     return false;
 }
 
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+static uint8_t last_hit_oldest(void) {
+    uint8_t head = last_hit_buffer.head;
+    return head >= last_hit_buffer.count ? head - last_hit_buffer.count : head + LED_HITS_TO_REMEMBER - last_hit_buffer.count;
+}
+
+// Copies the hits to the tracker read by the effects, oldest first, with their age in ms.
+static void last_hit_update_tracker(void) {
+    uint8_t slot = last_hit_oldest();
+
+    memset(g_last_hit_tracker.leds, 0, sizeof(g_last_hit_tracker.leds));
+    for (uint8_t i = 0; i < last_hit_buffer.count; i++) {
+        uint8_t led                 = last_hit_buffer.index[slot];
+        g_last_hit_tracker.x[i]     = g_led_config.point[led].x;
+        g_last_hit_tracker.y[i]     = g_led_config.point[led].y;
+        g_last_hit_tracker.index[i] = led;
+        g_last_hit_tracker.tick[i]  = g_rgb_timer - last_hit_buffer.time[slot];
+        g_last_hit_tracker.leds[led / 8] |= 1 << (led % 8);
+        slot = slot + 1 < LED_HITS_TO_REMEMBER ? slot + 1 : 0;
+    }
+    g_last_hit_tracker.count = last_hit_buffer.count;
+}
+#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+
 static void rgb_task_timers(void) {
-#if defined(RGB_MATRIX_KEYREACTIVE_ENABLED)
-    uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
-#endif // defined(RGB_MATRIX_KEYREACTIVE_ENABLED)
     rgb_timer_buffer = sync_timer_read32();
 
-    // Update double buffer last hit timers
+    // Expire hits whose age no longer fits the tracker ticks
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
-            continue;
-        }
-        last_hit_buffer.tick[i] += deltaTime;
+    while (last_hit_buffer.count && rgb_timer_buffer - last_hit_buffer.time[last_hit_oldest()] > UINT16_MAX) {
+        last_hit_buffer.count--;
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 }
 
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+// A slice is usually much shorter than a timer tick, so it mostly measures as
+// 0ms and sometimes as 1ms. The chance of a slice crossing a tick grows with
+// its duration though, so summed over many slices the error averages out.
+static void rgb_process_record(struct rgb_matrix_limits_t slice, fast_timer_t elapsed) {
+    if (slice.led_max_index > slice.led_min_index) {
+        rgb_process_leds += slice.led_max_index - slice.led_min_index;
+    }
+    rgb_process_time += elapsed;
+}
+
+// Only called between frames, as all slices of a frame must have the same size.
+static void rgb_process_adapt(void) {
+    if (timer_elapsed_fast(rgb_process_window) < RGB_MATRIX_LED_PROCESS_ADAPT_INTERVAL) return;
+    rgb_process_window = timer_read_fast();
+    if (rgb_process_leds == 0) return;
+
+    uint32_t limit = (uint32_t)rgb_process_limit * 2;
+    if (rgb_process_time > 0) {
+        limit = (uint32_t)RGB_MATRIX_LED_PROCESS_TARGET_US * rgb_process_leds / (rgb_process_time * 1000);
+    }
+
+    // change by at most a factor of two per window, so a single outlier doesn't stall the animations
+    if (limit > (uint32_t)rgb_process_limit * 2) limit = (uint32_t)rgb_process_limit * 2;
+    if (limit < rgb_process_limit / 2) limit = rgb_process_limit / 2;
+    if (limit > RGB_MATRIX_LED_COUNT) limit = RGB_MATRIX_LED_COUNT;
+    if (limit < 1) limit = 1;
+
+    if (limit != rgb_process_limit) {
+        dprintf("rgb_matrix: process limit %u -> %u LEDs, %lu us per LED\n", rgb_process_limit, (uint8_t)limit, (unsigned long)(rgb_process_time * 1000 / rgb_process_leds));
+        rgb_process_limit = limit;
+    }
+    rgb_process_leds = 0;
+    rgb_process_time = 0;
+}
+#endif // RGB_MATRIX_LED_PROCESS_ADAPTIVE
+
 static void rgb_task_sync(void) {
     eeconfig_flush_rgb_matrix(false);
     // next task
@@ -267,11 +346,14 @@ static void rgb_task_sync(void) {
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+    rgb_process_adapt();
+#endif // RGB_MATRIX_LED_PROCESS_ADAPTIVE
 
     // update double buffers
     g_rgb_timer = rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    g_last_hit_tracker = last_hit_buffer;
+    last_hit_update_tracker();
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     // next task
@@ -367,15 +449,23 @@ void rgb_matrix_task(void) {
         case STARTING:
             rgb_task_start();
             break;
-        case RENDERING:
+        case RENDERING: {
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+            struct rgb_matrix_limits_t slice       = rgb_matrix_get_limits(rgb_effect_params.iter);
+            fast_timer_t               slice_start = timer_read_fast();
+#endif // RGB_MATRIX_LED_PROCESS_ADAPTIVE
             rgb_task_render(effect);
             if (effect) {
                 if (rgb_task_state == FLUSHING) { // ensure we only draw basic indicators once rendering is finished
                     rgb_matrix_indicators();
                 }
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+                rgb_process_record(slice, timer_elapsed_fast(slice_start));
+#endif // RGB_MATRIX_LED_PROCESS_ADAPTIVE
             }
             break;
+        }
         case FLUSHING:
             rgb_task_flush(effect);
             break;
@@ -397,20 +487,28 @@ __attribute__((weak)) bool rgb_matrix_indicators_user(void) {
     return true;
 }
 
+uint8_t rgb_matrix_get_process_limit(void) {
+#if defined(RGB_MATRIX_LED_PROCESS_SLICE)
+    return RGB_MATRIX_LED_PROCESS_SLICE;
+#else
+    return RGB_MATRIX_LED_COUNT;
+#endif
+}
+
 struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter) {
     struct rgb_matrix_limits_t limits = {0};
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#if defined(RGB_MATRIX_LED_PROCESS_SLICE)
+    // computed wider than the limits, as the slice boundaries pass 255 on boards with more than 128 LEDs
+    uint16_t led_min_index = (uint16_t)RGB_MATRIX_LED_PROCESS_SLICE * (iter);
+    uint16_t led_max_index = led_min_index + RGB_MATRIX_LED_PROCESS_SLICE;
+    if (led_min_index > RGB_MATRIX_LED_COUNT) led_min_index = RGB_MATRIX_LED_COUNT;
+    if (led_max_index > RGB_MATRIX_LED_COUNT) led_max_index = RGB_MATRIX_LED_COUNT;
+    limits.led_min_index = led_min_index;
+    limits.led_max_index = led_max_index;
 #    if defined(RGB_MATRIX_SPLIT)
-    limits.led_min_index = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);
-    limits.led_max_index = limits.led_min_index + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (limits.led_max_index > RGB_MATRIX_LED_COUNT) limits.led_max_index = RGB_MATRIX_LED_COUNT;
     uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
     if (is_keyboard_left() && (limits.led_max_index > k_rgb_matrix_split[0])) limits.led_max_index = k_rgb_matrix_split[0];
     if (!(is_keyboard_left()) && (limits.led_min_index < k_rgb_matrix_split[0])) limits.led_min_index = k_rgb_matrix_split[0];
-#    else
-    limits.led_min_index = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);
-    limits.led_max_index = limits.led_min_index + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (limits.led_max_index > RGB_MATRIX_LED_COUNT) limits.led_max_index = RGB_MATRIX_LED_COUNT;
 #    endif
 #else
 #    if defined(RGB_MATRIX_SPLIT)
@@ -445,19 +543,33 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
     return true;
 }
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+static void rgb_matrix_init_geometry(void) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx = rgb_matrix_led_dx(i);
+        int16_t dy = rgb_matrix_led_dy(i);
+
+        g_rgb_geometry[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_rgb_geometry[i].angle = atan2_8(dy, dx);
+    }
+}
+#endif // RGB_MATRIX_GEOMETRY_CACHE
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    rgb_matrix_init_geometry();
+#endif
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
         g_last_hit_tracker.tick[i] = UINT16_MAX;
     }
 
+    last_hit_buffer.head  = 0;
     last_hit_buffer.count = 0;
-    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
-        last_hit_buffer.tick[i] = UINT16_MAX;
-    }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     eeconfig_init_rgb_matrix();
@@ -90,6 +90,15 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
 #endif
 
+#ifdef RGB_MATRIX_LED_PROCESS_ADAPTIVE
+#    ifndef RGB_MATRIX_LED_PROCESS_TARGET_US
+#        define RGB_MATRIX_LED_PROCESS_TARGET_US 250
+#    endif
+#    ifndef RGB_MATRIX_LED_PROCESS_ADAPT_INTERVAL
+#        define RGB_MATRIX_LED_PROCESS_ADAPT_INTERVAL 1000
+#    endif
+#endif
+
 struct rgb_matrix_limits_t {
     uint8_t led_min_index;
     uint8_t led_max_index;
@@ -97,6 +106,9 @@ struct rgb_matrix_limits_t {
 
 struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter);
 
+// Number of LEDs rendered per task run
+uint8_t rgb_matrix_get_process_limit(void);
+
 #define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter)                   \
     struct rgb_matrix_limits_t limits = rgb_matrix_get_limits(iter); \
     uint8_t                    min    = limits.led_min_index;        \
@@ -277,3 +289,6 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+extern led_geometry_t g_rgb_geometry[RGB_MATRIX_LED_COUNT];
+#endif
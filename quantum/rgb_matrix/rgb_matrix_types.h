@@ -16,6 +16,10 @@
 
 #pragma once
 
+#ifdef __cplusplus
+#    define _Static_assert static_assert
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 #include "color.h"
@@ -30,14 +34,28 @@
 #    define LED_HITS_TO_REMEMBER 8
 #endif // LED_HITS_TO_REMEMBER
 
+#if LED_HITS_TO_REMEMBER > UINT8_MAX
+#    error "LED_HITS_TO_REMEMBER must not be greater than 255"
+#endif
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+// Hits of the current frame, oldest first
 typedef struct PACKED {
     uint8_t  count;
     uint8_t  x[LED_HITS_TO_REMEMBER];
     uint8_t  y[LED_HITS_TO_REMEMBER];
     uint8_t  index[LED_HITS_TO_REMEMBER];
     uint16_t tick[LED_HITS_TO_REMEMBER];
+    uint8_t  leds[(RGB_MATRIX_LED_COUNT + 7) / 8]; // one bit per LED, set if it has any hit
 } last_hit_t;
+
+// Hits as they are recorded, in a ring buffer
+typedef struct PACKED {
+    uint8_t  head; // slot of the next hit
+    uint8_t  count;
+    uint8_t  index[LED_HITS_TO_REMEMBER];
+    uint32_t time[LED_HITS_TO_REMEMBER];
+} last_hit_ring_t;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 typedef enum rgb_task_states { STARTING, RENDERING, FLUSHING, SYNCING } rgb_task_states;
@@ -55,6 +73,11 @@ typedef struct PACKED {
     uint8_t y;
 } led_point_t;
 
+typedef struct PACKED {
+    uint8_t dist;  // sqrt16(dx * dx + dy * dy) from k_rgb_matrix_center
+    uint8_t angle; // atan2_8(dy, dx) around k_rgb_matrix_center
+} led_geometry_t;
+
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 #define HAS_ANY_FLAGS(bits, flags) ((bits & flags) != 0x00)
 
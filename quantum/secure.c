@@ -3,6 +3,7 @@
 
 #include "secure.h"
 #include "timer.h"
+#include "soft_timer.h"
 #include "util.h"
 
 #ifndef SECURE_UNLOCK_TIMEOUT
@@ -24,6 +25,8 @@ static secure_status_t secure_status = SECURE_LOCKED;
 static uint32_t        unlock_time   = 0;
 static uint32_t        idle_time     = 0;
 
+static void secure_update_timer(void);
+
 static void secure_hook(secure_status_t secure_status) {
     secure_hook_quantum(secure_status);
     secure_hook_kb(secure_status);
@@ -35,12 +38,14 @@ secure_status_t secure_get_status(void) {
 
 void secure_lock(void) {
     secure_status = SECURE_LOCKED;
+    secure_update_timer();
     secure_hook(secure_status);
 }
 
 void secure_unlock(void) {
     secure_status = SECURE_UNLOCKED;
     idle_time     = timer_read32();
+    secure_update_timer();
     secure_hook(secure_status);
 }
 
@@ -48,6 +53,7 @@ void secure_request_unlock(void) {
     if (secure_status == SECURE_LOCKED) {
         secure_status = SECURE_PENDING;
         unlock_time   = timer_read32();
+        secure_update_timer();
     }
     secure_hook(secure_status);
 }
@@ -55,6 +61,7 @@ void secure_request_unlock(void) {
 void secure_activity_event(void) {
     if (secure_status == SECURE_UNLOCKED) {
         idle_time = timer_read32();
+        secure_update_timer();
     }
 }
 
@@ -95,6 +102,30 @@ void secure_task(void) {
 #endif
 }
 
+#if SECURE_UNLOCK_TIMEOUT != 0 || SECURE_IDLE_TIMEOUT != 0
+static uint32_t secure_remaining(uint32_t since, uint32_t timeout) {
+    uint32_t elapsed = timer_elapsed32(since);
+    return elapsed >= timeout ? 0 : timeout - elapsed;
+}
+#endif
+
+// Wakes secure_task() up when the current state times out.
+static void secure_update_timer(void) {
+#if SECURE_UNLOCK_TIMEOUT != 0
+    if (secure_status == SECURE_PENDING) {
+        soft_timer_start(SOFT_TIMER_SECURE, secure_remaining(unlock_time, SECURE_UNLOCK_TIMEOUT), secure_task);
+        return;
+    }
+#endif
+#if SECURE_IDLE_TIMEOUT != 0
+    if (secure_status == SECURE_UNLOCKED) {
+        soft_timer_start(SOFT_TIMER_SECURE, secure_remaining(idle_time, SECURE_IDLE_TIMEOUT), secure_task);
+        return;
+    }
+#endif
+    soft_timer_stop(SOFT_TIMER_SECURE);
+}
+
 __attribute__((weak)) bool secure_hook_user(secure_status_t secure_status) {
     return true;
 }
@@ -24,6 +24,14 @@
 #include "action.h"
 #include "wait.h"
 
+#ifdef SEND_STRING_QUEUE_SIZE
+#    include "timer.h"
+#    include "quantum.h"
+#    ifdef UNICODE_COMMON_ENABLE
+#        include "unicode.h"
+#    endif
+#endif
+
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
 #    include "audio.h"
 #    ifndef BELL_SOUND
@@ -336,3 +344,219 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
     }
 }
 #endif
+
+#ifdef SEND_STRING_QUEUE_SIZE
+#    if SEND_STRING_QUEUE_SIZE > 255
+#        error SEND_STRING_QUEUE_SIZE must be 255 or less
+#    endif
+
+#    ifndef SEND_STRING_QUEUE_INTERVAL
+#        define SEND_STRING_QUEUE_INTERVAL 1
+#    endif
+
+enum send_string_action_type {
+    SEND_STRING_ACTION_REGISTER,
+    SEND_STRING_ACTION_UNREGISTER,
+    SEND_STRING_ACTION_DELAY,
+    SEND_STRING_ACTION_UNICODE,
+};
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  high;
+    uint16_t value;
+} send_string_action_t;
+
+static send_string_action_t send_string_queue[SEND_STRING_QUEUE_SIZE];
+static uint8_t              send_string_queue_head  = 0;
+static uint8_t              send_string_queue_count = 0;
+static fast_timer_t         send_string_queue_next  = 0;
+
+// Executes an action, returns the time in ms until the next one may run.
+static uint16_t send_string_queue_execute(send_string_action_t action) {
+    switch (action.type) {
+        case SEND_STRING_ACTION_REGISTER:
+            register_code16(action.value);
+            break;
+        case SEND_STRING_ACTION_UNREGISTER:
+            unregister_code16(action.value);
+            break;
+        case SEND_STRING_ACTION_DELAY:
+            return action.value;
+        case SEND_STRING_ACTION_UNICODE:
+#    ifdef UNICODE_COMMON_ENABLE
+            register_unicode(((uint32_t)action.high << 16) | action.value);
+#    endif
+            break;
+    }
+    return SEND_STRING_QUEUE_INTERVAL;
+}
+
+static void send_string_queue_pop(void) {
+    send_string_action_t action = send_string_queue[send_string_queue_head];
+    send_string_queue_head      = (send_string_queue_head + 1) % SEND_STRING_QUEUE_SIZE;
+    send_string_queue_count--;
+    send_string_queue_next = timer_read_fast() + send_string_queue_execute(action);
+}
+
+static void send_string_queue_push(uint8_t type, uint32_t value) {
+    if (send_string_queue_count == SEND_STRING_QUEUE_SIZE) {
+        // Queue is full: make room by sending the oldest action synchronously.
+        fast_timer_t now = timer_read_fast();
+        if (!timer_expired_fast(now, send_string_queue_next)) {
+            wait_ms(TIMER_DIFF_FAST(send_string_queue_next, now));
+        }
+        send_string_queue_pop();
+    } else if (send_string_queue_count == 0) {
+        // Nothing left to pace against, start right away.
+        send_string_queue_next = timer_read_fast();
+    }
+
+    uint8_t tail            = (send_string_queue_head + send_string_queue_count) % SEND_STRING_QUEUE_SIZE;
+    send_string_queue[tail] = (send_string_action_t){
+        .type  = type,
+        .high  = value >> 16,
+        .value = value & 0xFFFF,
+    };
+    send_string_queue_count++;
+}
+
+void send_string_queue_register(uint16_t keycode) {
+    send_string_queue_push(SEND_STRING_ACTION_REGISTER, keycode);
+}
+
+void send_string_queue_unregister(uint16_t keycode) {
+    send_string_queue_push(SEND_STRING_ACTION_UNREGISTER, keycode);
+}
+
+void send_string_queue_tap(uint16_t keycode) {
+    send_string_queue_register(keycode);
+    send_string_queue_unregister(keycode);
+}
+
+void send_string_queue_delay(uint16_t ms) {
+    if (ms > 0) {
+        send_string_queue_push(SEND_STRING_ACTION_DELAY, ms);
+    }
+}
+
+void send_string_queue_unicode(uint32_t code_point) {
+    send_string_queue_push(SEND_STRING_ACTION_UNICODE, code_point);
+}
+
+bool send_string_queue_is_empty(void) {
+    return send_string_queue_count == 0;
+}
+
+void send_string_task(void) {
+    if (send_string_queue_count > 0 && timer_expired_fast(timer_read_fast(), send_string_queue_next)) {
+        send_string_queue_pop();
+    }
+}
+
+void send_char_queued_with_delay(char ascii_code, uint8_t interval) {
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') { // BEL
+        PLAY_SONG(bell_song);
+        return;
+    }
+#    endif
+
+    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+    bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+    bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+
+    if (is_shifted) {
+        send_string_queue_register(KC_LEFT_SHIFT);
+        send_string_queue_delay(interval);
+    }
+
+    if (is_altgred) {
+        send_string_queue_register(KC_RIGHT_ALT);
+        send_string_queue_delay(interval);
+    }
+
+    send_string_queue_register(keycode);
+    send_string_queue_delay(interval);
+    send_string_queue_unregister(keycode);
+    send_string_queue_delay(interval);
+
+    if (is_altgred) {
+        send_string_queue_unregister(KC_RIGHT_ALT);
+        send_string_queue_delay(interval);
+    }
+
+    if (is_shifted) {
+        send_string_queue_unregister(KC_LEFT_SHIFT);
+        send_string_queue_delay(interval);
+    }
+
+    if (is_dead) {
+        send_string_queue_tap(KC_SPACE);
+        send_string_queue_delay(interval);
+    }
+}
+
+void send_char_queued(char ascii_code) {
+    send_char_queued_with_delay(ascii_code, TAP_CODE_DELAY);
+}
+
+static void send_string_queued_impl(const char *string, uint8_t interval, bool progmem) {
+#    define READ_CHAR(p) (progmem ? (char)pgm_read_byte(p) : *(p))
+    while (1) {
+        char ascii_code = READ_CHAR(string);
+        if (!ascii_code) break;
+        if (ascii_code == SS_QMK_PREFIX) {
+            ascii_code = READ_CHAR(++string);
+
+            if (ascii_code == SS_TAP_CODE) {
+                // tap
+                uint8_t keycode = READ_CHAR(++string);
+                send_string_queue_tap(keycode);
+            } else if (ascii_code == SS_DOWN_CODE) {
+                // down
+                uint8_t keycode = READ_CHAR(++string);
+                send_string_queue_register(keycode);
+            } else if (ascii_code == SS_UP_CODE) {
+                // up
+                uint8_t keycode = READ_CHAR(++string);
+                send_string_queue_unregister(keycode);
+            } else if (ascii_code == SS_DELAY_CODE) {
+                // delay
+                uint16_t ms      = 0;
+                uint8_t  keycode = READ_CHAR(++string);
+
+                while (isdigit(keycode)) {
+                    ms *= 10;
+                    ms += keycode - '0';
+                    keycode = READ_CHAR(++string);
+                }
+
+                send_string_queue_delay(ms);
+            }
+
+            send_string_queue_delay(interval);
+        } else {
+            send_char_queued_with_delay(ascii_code, interval);
+        }
+
+        ++string;
+    }
+#    undef READ_CHAR
+}
+
+void send_string_queued(const char *string) {
+    send_string_queued_with_delay(string, TAP_CODE_DELAY);
+}
+
+void send_string_queued_with_delay(const char *string, uint8_t interval) {
+    send_string_queued_impl(string, interval, false);
+}
+
+#    if defined(__AVR__)
+void send_string_queued_with_delay_P(const char *string, uint8_t interval) {
+    send_string_queued_impl(string, interval, true);
+}
+#    endif
+#endif // SEND_STRING_QUEUE_SIZE
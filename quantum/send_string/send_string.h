@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "progmem.h"
 #include "send_string_keycodes.h"
@@ -161,4 +162,93 @@ void send_string_with_delay_P(const char *string, uint8_t interval);
  */
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
 
+#if defined(SEND_STRING_QUEUE_SIZE) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a string of ASCII characters to be typed out by `send_string_task()`.
+ *
+ * Works like `send_string()`, but returns immediately: each key press, release and delay is queued and sent from the main loop,
+ * at most one every `SEND_STRING_QUEUE_INTERVAL` milliseconds, so scanning and other tasks keep running while the string is typed.
+ * If the queue is full, the oldest queued actions are sent synchronously to make room.
+ *
+ * \param string The string to type out.
+ */
+void send_string_queued(const char *string);
+
+/**
+ * \brief Queue a string of ASCII characters, with a delay between each character.
+ *
+ * \param string The string to type out.
+ * \param interval The amount of time, in milliseconds, to wait in between key presses, on top of `SEND_STRING_QUEUE_INTERVAL`.
+ */
+void send_string_queued_with_delay(const char *string, uint8_t interval);
+
+/**
+ * \brief Queue an ASCII character to be typed out by `send_string_task()`.
+ *
+ * \param ascii_code The character to type.
+ */
+void send_char_queued(char ascii_code);
+
+/**
+ * \brief Queue an ASCII character, with a delay between any modifiers.
+ *
+ * \param ascii_code The character to type.
+ * \param interval The amount of time, in milliseconds, to wait in between key presses, on top of `SEND_STRING_QUEUE_INTERVAL`.
+ */
+void send_char_queued_with_delay(char ascii_code, uint8_t interval);
+
+/**
+ * \brief Queue the press of a keycode.
+ */
+void send_string_queue_register(uint16_t keycode);
+
+/**
+ * \brief Queue the release of a keycode.
+ */
+void send_string_queue_unregister(uint16_t keycode);
+
+/**
+ * \brief Queue the press and release of a keycode.
+ */
+void send_string_queue_tap(uint16_t keycode);
+
+/**
+ * \brief Queue a pause, in milliseconds.
+ */
+void send_string_queue_delay(uint16_t ms);
+
+/**
+ * \brief Queue the input of a single Unicode character, see `register_unicode()`.
+ *
+ * Requires one of the Unicode features to be enabled.
+ */
+void send_string_queue_unicode(uint32_t code_point);
+
+/**
+ * \brief Whether everything queued has been sent.
+ */
+bool send_string_queue_is_empty(void);
+
+/**
+ * \brief Sends the next queued action when it is due. Called from the main loop.
+ */
+void send_string_task(void);
+
+#    if defined(__AVR__) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a PROGMEM string of ASCII characters, with a delay between each character.
+ *
+ * On ARM devices, this function is simply an alias for send_string_queued_with_delay(string, interval).
+ */
+void send_string_queued_with_delay_P(const char *string, uint8_t interval);
+#    else
+#        define send_string_queued_with_delay_P(string, interval) send_string_queued_with_delay(string, interval)
+#    endif
+
+/**
+ * \brief Shortcut macro for send_string_queued_with_delay_P(PSTR(string), 0).
+ */
+#    define SEND_STRING_QUEUED(string) send_string_queued_with_delay_P(PSTR(string), 0)
+#endif
+
 /** \} */
@@ -0,0 +1,75 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "soft_timer.h"
+#include "timer.h"
+
+typedef struct {
+    uint32_t              due;
+    soft_timer_callback_t callback;
+    bool                  pending;
+} soft_timer_t;
+
+static soft_timer_t soft_timers[SOFT_TIMER_COUNT];
+static bool         any_pending = false;
+static uint32_t     next_due    = 0;
+
+static void soft_timer_update_next(void) {
+    any_pending = false;
+    for (uint8_t i = 0; i < SOFT_TIMER_COUNT; i++) {
+        if (soft_timers[i].pending && (!any_pending || (int32_t)TIMER_DIFF_32(soft_timers[i].due, next_due) < 0)) {
+            next_due    = soft_timers[i].due;
+            any_pending = true;
+        }
+    }
+}
+
+void soft_timer_start(soft_timer_id_t id, uint32_t delay_ms, soft_timer_callback_t callback) {
+    soft_timers[id] = (soft_timer_t){
+        .due      = timer_read32() + delay_ms,
+        .callback = callback,
+        .pending  = true,
+    };
+    soft_timer_update_next();
+}
+
+void soft_timer_stop(soft_timer_id_t id) {
+    if (soft_timers[id].pending) {
+        soft_timers[id].pending = false;
+        soft_timer_update_next();
+    }
+}
+
+bool soft_timer_pending(soft_timer_id_t id) {
+    return soft_timers[id].pending;
+}
+
+uint32_t soft_timer_next(void) {
+    if (!any_pending) {
+        return SOFT_TIMER_IDLE;
+    }
+
+    uint32_t now = timer_read32();
+    return timer_expired32(now, next_due) ? 0 : next_due - now;
+}
+
+void soft_timer_task(void) {
+    if (!any_pending) {
+        return;
+    }
+
+    uint32_t now = timer_read32();
+    if (!timer_expired32(now, next_due)) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < SOFT_TIMER_COUNT; i++) {
+        soft_timer_t *timer = &soft_timers[i];
+        if (timer->pending && timer_expired32(now, timer->due)) {
+            // Cleared first, so that the callback can start the timer again.
+            timer->pending = false;
+            timer->callback();
+        }
+    }
+    soft_timer_update_next();
+}
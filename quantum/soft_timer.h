@@ -0,0 +1,82 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+    Shared timeouts for quantum features.
+
+    Instead of polling their own timers on every loop iteration, features
+    start a soft timer whenever they begin waiting for something, and get a
+    callback from `soft_timer_task()` once it is due. While no timer is
+    pending the task returns straight away, and `soft_timer_next()` tells the
+    main loop how long it may wait before the next callback is needed.
+
+    Each feature owns one timer. Starting a timer that is already pending
+    moves its deadline, stopping it drops the pending callback.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+#ifdef TAP_DANCE_ENABLE
+    SOFT_TIMER_TAP_DANCE,
+#endif
+#ifdef COMBO_ENABLE
+    SOFT_TIMER_COMBO,
+#endif
+#ifdef LEADER_ENABLE
+    SOFT_TIMER_LEADER,
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+    SOFT_TIMER_AUTO_SHIFT,
+#endif
+#ifdef CAPS_WORD_ENABLE
+    SOFT_TIMER_CAPS_WORD,
+#endif
+#ifdef SECURE_ENABLE
+    SOFT_TIMER_SECURE,
+#endif
+#ifdef KEY_OVERRIDE_ENABLE
+    SOFT_TIMER_KEY_OVERRIDE,
+#endif
+    SOFT_TIMER_COUNT
+} soft_timer_id_t;
+
+typedef void (*soft_timer_callback_t)(void);
+
+/**
+ * \brief Value returned by `soft_timer_next()` when no timer is pending.
+ */
+#define SOFT_TIMER_IDLE UINT32_MAX
+
+/**
+ * \brief Starts or restarts a timer.
+ *
+ * \param id the timer to start
+ * \param delay_ms milliseconds from now until the callback is due
+ * \param callback function to call once the timer is due
+ */
+void soft_timer_start(soft_timer_id_t id, uint32_t delay_ms, soft_timer_callback_t callback);
+
+/**
+ * \brief Stops a timer, its callback will not be called.
+ */
+void soft_timer_stop(soft_timer_id_t id);
+
+/**
+ * \brief Whether the timer has been started and its callback has not been called yet.
+ */
+bool soft_timer_pending(soft_timer_id_t id);
+
+/**
+ * \brief Milliseconds until the next callback is due.
+ *
+ * \return 0 if a callback is already due, or SOFT_TIMER_IDLE if no timer is pending
+ */
+uint32_t soft_timer_next(void);
+
+/**
+ * \brief Calls the callbacks of due timers, in order of their id.
+ */
+void soft_timer_task(void);
@@ -390,3 +390,20 @@ void send_unicode_string(const char *str) {
         }
     }
 }
+
+#ifdef SEND_STRING_QUEUE_SIZE
+void send_unicode_string_queued(const char *str) {
+    if (!str) {
+        return;
+    }
+
+    while (*str) {
+        int32_t code_point = 0;
+        str                = decode_utf8(str, &code_point);
+
+        if (code_point >= 0) {
+            send_string_queue_unicode(code_point);
+        }
+    }
+}
+#endif
@@ -131,4 +131,13 @@ void register_unicode(uint32_t code_point);
  */
 void send_unicode_string(const char *str);
 
+#if defined(SEND_STRING_QUEUE_SIZE) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a string containing Unicode characters to be sent by `send_string_task()`, one character at a time.
+ *
+ * \param str The string to send.
+ */
+void send_unicode_string_queued(const char *str);
+#endif
+
 /** \} */
@@ -0,0 +1,9 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+# The basic tests, with the layer lookup cache
+SRC += ../test_action_layer.cpp ../test_keycode_util.cpp ../test_keypress.cpp ../test_one_shot_keys.cpp ../test_tapping.cpp
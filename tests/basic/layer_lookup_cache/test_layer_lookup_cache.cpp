@@ -0,0 +1,151 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerLookupCache : public TestFixture {
+   protected:
+    /* Uncached reference implementation of the top-down layer walk. */
+    uint8_t reference_layer(keypos_t key) {
+        layer_state_t layers = layer_state | default_layer_state;
+        for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+            if (layers & ((layer_state_t)1 << i)) {
+                if (action_for_key(i, key).code != ACTION_TRANSPARENT) {
+                    return i;
+                }
+            }
+        }
+        return 0;
+    }
+
+    void expect_same_as_walk(std::initializer_list<KeymapKey> keys) {
+        for (auto& key : keys) {
+            EXPECT_EQ(layer_switch_get_layer(key.position), reference_layer(key.position)) << "layer_state " << +layer_state << " default_layer_state " << +default_layer_state << " key (" << +key.position.col << "," << +key.position.row << ")";
+        }
+    }
+};
+
+TEST_F(LayerLookupCache, MatchesLayerWalkForAllLayerStates) {
+    TestDriver driver;
+
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+    auto key_b = KeymapKey(0, 1, 0, KC_B);
+    auto key_c = KeymapKey(0, 2, 1, KC_C);
+
+    set_keymap({key_a, key_b, key_c,
+                /* layer 1 */
+                KeymapKey(1, 0, 0, KC_1), KeymapKey(1, 1, 0, KC_TRNS), KeymapKey(1, 2, 1, KC_TRNS),
+                /* layer 2 */
+                KeymapKey(2, 0, 0, KC_TRNS), KeymapKey(2, 1, 0, KC_2), KeymapKey(2, 2, 1, KC_TRNS),
+                /* layer 3 */
+                KeymapKey(3, 0, 0, KC_TRNS), KeymapKey(3, 1, 0, KC_TRNS), KeymapKey(3, 2, 1, KC_3)});
+
+    for (layer_state_t default_state = 1; default_state <= 2; default_state++) {
+        default_layer_set(default_state);
+        for (layer_state_t state = 0; state < 16; state++) {
+            layer_state_set(state);
+            expect_same_as_walk({key_a, key_b, key_c});
+        }
+    }
+
+    default_layer_set(1);
+    layer_clear();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, FollowsDirectLayerStateWrites) {
+    TestDriver driver;
+
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_1)});
+
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+    layer_state = 0b10;
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 1);
+    layer_state = 0;
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, KeymapChangeInvalidatesCache) {
+    TestDriver driver;
+
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_TRNS)});
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_1)});
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 1);
+
+    layer_clear();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, TransparentKeyFallsThroughMomentaryLayer) {
+    TestDriver driver;
+    InSequence s;
+
+    auto key_a      = KeymapKey(0, 0, 0, KC_A);
+    auto key_b      = KeymapKey(0, 1, 0, KC_B);
+    auto key_layer  = KeymapKey(0, 2, 0, MO(1));
+    auto key_a_trns = KeymapKey(1, 0, 0, KC_TRNS);
+    auto key_b_1    = KeymapKey(1, 1, 0, KC_1);
+    auto key_trns   = KeymapKey(1, 2, 0, KC_TRNS);
+
+    set_keymap({key_a, key_b, key_layer, key_a_trns, key_b_1, key_trns});
+
+    /* Resolve both keys on the base layer first, so the cache is populated. */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    key_layer.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a_trns);
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b_1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    key_layer.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+}
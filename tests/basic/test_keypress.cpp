@@ -290,3 +290,92 @@ TEST_F(KeyPress, PressEqualPlusDontReleaseBeforePress) {
     run_one_scan_loop();
     VERIFY_AND_CLEAR(driver);
 }
+
+TEST_F(KeyPress, SeventhKeyIsNotReportedWith6KRO) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 4, 0, KC_E);
+    auto       key_f = KeymapKey(0, 5, 0, KC_F);
+    auto       key_g = KeymapKey(0, 6, 0, KC_G);
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e, key_f, key_g});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    for (auto key : {key_a, key_b, key_c, key_d, key_e, key_f, key_g}) {
+        key.press();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(has_anykey(), 7);
+    EXPECT_TRUE(is_key_pressed(KC_F));
+    EXPECT_TRUE(is_key_pressed(KC_G));
+
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E, KC_F));
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(is_key_pressed(KC_A));
+    EXPECT_EQ(has_anykey(), 6);
+
+    /* Releasing the key that didn't fit doesn't change the report. */
+    EXPECT_NO_REPORT(driver);
+    key_g.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_D, KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_D, KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_E, KC_F));
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    for (auto key : {key_b, key_c, key_d, key_e, key_f}) {
+        key.release();
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(has_anykey(), 0);
+}
+
+TEST_F(KeyPress, ReportIsTrackedAcrossClearKeyboard) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    add_key_to_report(KC_A);
+    add_key_to_report(KC_A);
+    add_key_to_report(KC_B);
+    send_keyboard_report();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_TRUE(is_key_pressed(KC_A));
+    EXPECT_FALSE(is_key_pressed(KC_C));
+    EXPECT_FALSE(is_key_pressed(KC_NO));
+    EXPECT_EQ(has_anykey(), 2);
+
+    EXPECT_EMPTY_REPORT(driver);
+    clear_keyboard();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_FALSE(is_key_pressed(KC_A));
+    EXPECT_EQ(has_anykey(), 0);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    add_key_to_report(KC_C);
+    send_keyboard_report();
+    del_key_from_report(KC_C);
+    send_keyboard_report();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,13 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+COMBO_ENABLE = yes
+
+# The combo tests, with the keycode to combo index
+SRC += ../test_combo.cpp
+
+INTROSPECTION_KEYMAP_C = ../test_combos.c
@@ -0,0 +1,112 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "quantum.h"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_logger.hpp"
+
+#define LARGE_TABLE_COMBO_KEYS 25
+#define LARGE_TABLE_COMBO_COUNT (LARGE_TABLE_COMBO_KEYS * (LARGE_TABLE_COMBO_KEYS - 1) / 2)
+
+/* Every pair out of the first LARGE_TABLE_COMBO_KEYS letters is a combo. */
+static uint16_t large_table_combo_keys[LARGE_TABLE_COMBO_COUNT][3];
+static combo_t  large_table_combos[LARGE_TABLE_COMBO_COUNT];
+static bool     large_table_combos_initialized = false;
+static uint32_t large_table_combo_get_calls    = 0;
+
+static uint16_t large_table_combo_result(uint16_t combo_idx) {
+    return KC_F1 + (combo_idx % 12);
+}
+
+static void large_table_combos_init(void) {
+    uint16_t idx = 0;
+    for (uint8_t first = 0; first < LARGE_TABLE_COMBO_KEYS; first++) {
+        for (uint8_t second = first + 1; second < LARGE_TABLE_COMBO_KEYS; second++) {
+            large_table_combo_keys[idx][0]  = KC_A + first;
+            large_table_combo_keys[idx][1]  = KC_A + second;
+            large_table_combo_keys[idx][2]  = COMBO_END;
+            large_table_combos[idx]         = {};
+            large_table_combos[idx].keys    = large_table_combo_keys[idx];
+            large_table_combos[idx].keycode = large_table_combo_result(idx);
+            idx++;
+        }
+    }
+    large_table_combos_initialized = true;
+}
+
+extern "C" uint16_t combo_count(void) {
+    return LARGE_TABLE_COMBO_COUNT;
+}
+
+extern "C" combo_t *combo_get(uint16_t combo_idx) {
+    if (!large_table_combos_initialized) {
+        large_table_combos_init();
+    }
+    large_table_combo_get_calls++;
+    return &large_table_combos[combo_idx];
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class ComboLargeTable : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t i = 0; i < LARGE_TABLE_COMBO_KEYS; i++) {
+            keys.emplace_back(0, i % MATRIX_COLS, i / MATRIX_COLS, KC_A + i);
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    /* Index of the combo made of the letters at positions first < second. */
+    uint16_t combo_index(uint8_t first, uint8_t second) {
+        return first * LARGE_TABLE_COMBO_KEYS - first * (first + 1) / 2 + (second - first - 1);
+    }
+};
+
+TEST_F(ComboLargeTable, every_combo_in_large_table_resolves) {
+    TestDriver driver;
+
+    for (auto [first, second] : std::vector<std::pair<uint8_t, uint8_t>>{{0, 1}, {0, 24}, {7, 19}, {12, 13}, {23, 24}}) {
+        EXPECT_REPORT(driver, (large_table_combo_result(combo_index(first, second))));
+        EXPECT_EMPTY_REPORT(driver);
+        tap_combo({keys[first], keys[second]});
+        VERIFY_AND_CLEAR(driver);
+    }
+}
+
+TEST_F(ComboLargeTable, key_events_only_visit_candidate_combos) {
+    TestDriver driver;
+    const int  rounds = 200;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    /* Let the index build first. */
+    tap_combo({keys[0], keys[1]});
+
+    large_table_combo_get_calls = 0;
+    for (int i = 0; i < rounds; i++) {
+        uint8_t first  = i % LARGE_TABLE_COMBO_KEYS;
+        uint8_t second = (first + 1 + (i * 7) % (LARGE_TABLE_COMBO_KEYS - 1)) % LARGE_TABLE_COMBO_KEYS;
+        tap_combo({keys[first], keys[second]});
+    }
+
+    /* Each tap_combo is two presses and two releases. A linear scan visits
+     * every combo at least once per event, the index only the combos with
+     * the pressed key in them. */
+    const uint32_t events = rounds * 4;
+    EXPECT_LT(large_table_combo_get_calls / events, LARGE_TABLE_COMBO_COUNT / 4);
+    VERIFY_AND_CLEAR(driver);
+}
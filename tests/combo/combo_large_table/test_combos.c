@@ -0,0 +1,6 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+// The table is generated at runtime, see combo_get() in test_combo_large_table.cpp
+combo_t key_combos[] = {};
@@ -0,0 +1,241 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+struct execution_t {
+    uintptr_t id;
+    uint32_t  trigger_time;
+    uint32_t  now;
+};
+
+static std::vector<execution_t> executions;
+static uint32_t                 repeat_delay = 0;
+
+static uint32_t record_callback(uint32_t trigger_time, void *cb_arg) {
+    executions.push_back({(uintptr_t)cb_arg, trigger_time, timer_read32()});
+    return repeat_delay;
+}
+
+class DeferredExec : public TestFixture {
+   public:
+    void SetUp() override {
+        executions.clear();
+        repeat_delay = 0;
+
+        /* The background task is throttled against the last time it ran, so every test starts later than the previous one. */
+        static uint32_t next_start = 0;
+        next_start += 100000;
+        start = next_start;
+        set_time(start);
+    }
+
+    void TearDown() override {
+        for (auto token : tokens) {
+            cancel_deferred_exec(token);
+        }
+    }
+
+    deferred_token defer(uint32_t delay_ms, uintptr_t id) {
+        deferred_token token = defer_exec(delay_ms, record_callback, (void *)id);
+        tokens.push_back(token);
+        return token;
+    }
+
+    /* Runs the background task once per millisecond. */
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+
+    std::vector<deferred_token> tokens;
+    uint32_t                    start;
+};
+
+TEST_F(DeferredExec, ExecutesInTriggerOrder) {
+    defer(30, 3);
+    defer(10, 1);
+    defer(20, 2);
+
+    run_for(9);
+    EXPECT_TRUE(executions.empty());
+
+    run_for(30);
+    ASSERT_EQ(executions.size(), 3);
+    for (uintptr_t i = 0; i < 3; i++) {
+        EXPECT_EQ(executions[i].id, i + 1);
+        EXPECT_EQ(executions[i].trigger_time, start + 10 * (i + 1));
+        EXPECT_EQ(executions[i].now, executions[i].trigger_time);
+    }
+}
+
+TEST_F(DeferredExec, ExtendAndCancel) {
+    deferred_token first  = defer(10, 1);
+    deferred_token second = defer(20, 2);
+    defer(30, 3);
+
+    EXPECT_TRUE(extend_deferred_exec(first, 25));
+    EXPECT_TRUE(cancel_deferred_exec(second));
+    EXPECT_FALSE(cancel_deferred_exec(second));
+    EXPECT_FALSE(extend_deferred_exec(second, 5));
+
+    run_for(40);
+    ASSERT_EQ(executions.size(), 2);
+    EXPECT_EQ(executions[0].id, 1);
+    EXPECT_EQ(executions[0].trigger_time, start + 25);
+    EXPECT_EQ(executions[1].id, 3);
+    EXPECT_EQ(executions[1].trigger_time, start + 30);
+
+    /* Executed callbacks free their token */
+    EXPECT_FALSE(cancel_deferred_exec(first));
+}
+
+TEST_F(DeferredExec, RepeatsRelativeToTriggerTime) {
+    repeat_delay = 10;
+    defer(10, 1);
+
+    run_for(30);
+    ASSERT_EQ(executions.size(), 3);
+    EXPECT_EQ(executions[2].trigger_time, start + 30);
+
+    /* Running late keeps the cadence of the trigger times */
+    advance_time(15);
+    deferred_exec_task();
+    ASSERT_EQ(executions.size(), 4);
+    EXPECT_EQ(executions[3].trigger_time, start + 40);
+    EXPECT_EQ(executions[3].now, start + 45);
+
+    run_for(5);
+    ASSERT_EQ(executions.size(), 5);
+    EXPECT_EQ(executions[4].trigger_time, start + 50);
+
+    /* Falling a whole delay behind runs once, then again on the next tick */
+    advance_time(30);
+    deferred_exec_task();
+    ASSERT_EQ(executions.size(), 6);
+    run_for(1);
+    ASSERT_EQ(executions.size(), 7);
+    EXPECT_EQ(executions[6].trigger_time, start + 81);
+
+    repeat_delay = 0;
+    run_for(20);
+    EXPECT_EQ(executions.size(), 8);
+    run_for(20);
+    EXPECT_EQ(executions.size(), 8);
+}
+
+TEST_F(DeferredExec, ThrottledToOncePerMillisecond) {
+    defer(1, 1);
+    defer(2, 2);
+
+    advance_time(1);
+    deferred_exec_task();
+    deferred_exec_task();
+    EXPECT_EQ(executions.size(), 1);
+
+    advance_time(1);
+    deferred_exec_task();
+    EXPECT_EQ(executions.size(), 2);
+}
+
+TEST_F(DeferredExec, ManyExecutors) {
+
+    /* Scatter the delays so they are not scheduled in trigger order */
+    for (uintptr_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        EXPECT_NE(defer(1 + (i * 37) % MAX_DEFERRED_EXECUTORS, i), INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer_exec(1, record_callback, NULL), INVALID_DEFERRED_TOKEN);
+
+    /* Cancelling frees a slot, the new token does not match the cancelled one */
+    deferred_token cancelled = tokens[5];
+    EXPECT_TRUE(cancel_deferred_exec(cancelled));
+    deferred_token replacement = defer(MAX_DEFERRED_EXECUTORS + 1, 5);
+    EXPECT_NE(replacement, INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(replacement, cancelled);
+    EXPECT_FALSE(cancel_deferred_exec(cancelled));
+
+    run_for(MAX_DEFERRED_EXECUTORS + 1);
+    ASSERT_EQ(executions.size(), MAX_DEFERRED_EXECUTORS);
+    for (size_t i = 0; i < executions.size(); i++) {
+        EXPECT_EQ(executions[i].now, executions[i].trigger_time);
+        if (i > 0) {
+            EXPECT_LT(executions[i - 1].trigger_time, executions[i].trigger_time);
+        }
+    }
+    EXPECT_EQ(executions.back().id, 5);
+}
+
+TEST_F(DeferredExec, CustomTable) {
+    deferred_executor_t table[3]      = {0};
+    uint32_t            last_executed = 0;
+
+    deferred_token a = defer_exec_advanced(table, 3, 5, record_callback, (void *)1);
+    deferred_token b = defer_exec_advanced(table, 3, 3, record_callback, (void *)2);
+    deferred_token c = defer_exec_advanced(table, 3, 4, record_callback, (void *)3);
+    EXPECT_NE(a, INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(b, INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(c, INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec_advanced(table, 3, 1, record_callback, NULL), INVALID_DEFERRED_TOKEN);
+
+    /* Tokens of the custom table are unknown to the basic API */
+    EXPECT_FALSE(cancel_deferred_exec(a));
+
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 3, c));
+    for (int i = 0; i < 5; i++) {
+        advance_time(1);
+        deferred_exec_advanced_task(table, 3, &last_executed);
+    }
+    ASSERT_EQ(executions.size(), 2);
+    EXPECT_EQ(executions[0].id, 2);
+    EXPECT_EQ(executions[1].id, 1);
+}
+
+TEST_F(DeferredExec, LargeTableKeepsTokensUnique) {
+    deferred_executor_t table[300] = {0};
+    deferred_token      last       = INVALID_DEFERRED_TOKEN;
+
+    /* Only the first 127 entries are used, so every slot has more than one token */
+    for (uintptr_t i = 0; i < 127; i++) {
+        last = defer_exec_advanced(table, 300, 10, record_callback, (void *)i);
+        EXPECT_NE(last, INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer_exec_advanced(table, 300, 10, record_callback, NULL), INVALID_DEFERRED_TOKEN);
+
+    /* The last slot gets a new token, the stale one is rejected */
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 300, last));
+    deferred_token replacement = defer_exec_advanced(table, 300, 10, record_callback, NULL);
+    EXPECT_NE(replacement, INVALID_DEFERRED_TOKEN);
+    EXPECT_NE(replacement, last);
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, 300, last));
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, 300, replacement));
+}
+
+TEST_F(DeferredExec, TablesKeepTheirOwnTokenGenerations) {
+    deferred_executor_t first[2]  = {0};
+    deferred_executor_t second[2] = {0};
+
+    /* However many tokens another table hands out in between, a freed token is not handed out again straight away */
+    for (int allocations = 0; allocations < 256; allocations++) {
+        deferred_token stale = defer_exec_advanced(first, 2, 10, record_callback, NULL);
+        EXPECT_TRUE(cancel_deferred_exec_advanced(first, 2, stale));
+
+        for (int i = 0; i < allocations; i++) {
+            deferred_token other = defer_exec_advanced(second, 2, 10, record_callback, NULL);
+            EXPECT_TRUE(cancel_deferred_exec_advanced(second, 2, other));
+        }
+
+        deferred_token replacement = defer_exec_advanced(first, 2, 10, record_callback, NULL);
+        EXPECT_NE(replacement, stale) << "after " << allocations << " allocations";
+        EXPECT_FALSE(cancel_deferred_exec_advanced(first, 2, stale)) << "after " << allocations << " allocations";
+        EXPECT_TRUE(cancel_deferred_exec_advanced(first, 2, replacement));
+    }
+}
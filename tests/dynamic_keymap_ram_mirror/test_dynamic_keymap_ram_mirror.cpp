@@ -0,0 +1,98 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+}
+
+class DynamicKeymapRamMirror : public TestFixture {
+   public:
+    void SetUp() override {
+        dynamic_keymap_reset();
+    }
+
+    /* The keycode stored in EEPROM, bypassing the mirror. */
+    uint16_t eeprom_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        return (eeprom_read_byte(address) << 8) | eeprom_read_byte(address + 1);
+    }
+
+    void set_eeprom_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        eeprom_update_byte(address, keycode >> 8);
+        eeprom_update_byte(address + 1, keycode & 0xFF);
+    }
+};
+
+TEST_F(DynamicKeymapRamMirror, SetKeycodeUpdatesMirrorAndEeprom) {
+    dynamic_keymap_set_keycode(1, 2, 3, LCTL(KC_B));
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), LCTL(KC_B));
+    EXPECT_EQ(eeprom_keycode(1, 2, 3), LCTL(KC_B));
+
+    /* Neighbouring keys are left alone. */
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 2), KC_TRNS);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 4), KC_TRNS);
+
+    /* Lookups are served from RAM once loaded. */
+    set_eeprom_keycode(1, 2, 3, KC_C);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), LCTL(KC_B));
+
+    /* Out of range keys are ignored. */
+    dynamic_keymap_set_keycode(DYNAMIC_KEYMAP_LAYER_COUNT, 0, 0, KC_A);
+    EXPECT_EQ(dynamic_keymap_get_keycode(DYNAMIC_KEYMAP_LAYER_COUNT, 0, 0), KC_NO);
+}
+
+TEST_F(DynamicKeymapRamMirror, SetBufferAcrossKeycodeBoundaries) {
+    dynamic_keymap_set_keycode(0, 0, 1, 0x1122);
+    dynamic_keymap_set_keycode(0, 0, 2, 0x3344);
+    dynamic_keymap_set_keycode(0, 0, 3, 0x5566);
+    dynamic_keymap_set_keycode(0, 0, 4, 0x7788);
+
+    /* Starts on the low byte of key 1 and ends on the high byte of key 4. */
+    uint8_t data[] = {0xA1, 0xB2, 0xB3, 0xC4, 0xC5, 0xD6};
+    dynamic_keymap_set_buffer(3, sizeof(data), data);
+
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), 0x11A1);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 2), 0xB2B3);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 3), 0xC4C5);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 4), 0xD688);
+    for (uint8_t column = 1; column <= 4; column++) {
+        EXPECT_EQ(eeprom_keycode(0, 0, column), dynamic_keymap_get_keycode(0, 0, column)) << "column " << (int)column;
+    }
+
+    uint8_t read[8];
+    dynamic_keymap_get_buffer(2, sizeof(read), read);
+    uint8_t expected[] = {0x11, 0xA1, 0xB2, 0xB3, 0xC4, 0xC5, 0xD6, 0x88};
+    for (uint8_t i = 0; i < sizeof(read); i++) {
+        EXPECT_EQ(read[i], expected[i]) << "byte " << (int)i;
+    }
+}
+
+TEST_F(DynamicKeymapRamMirror, SetBufferIsClampedToTheKeymap) {
+    const uint16_t keymap_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
+    uint8_t        data[]      = {0x12, 0x34, 0x56, 0x78};
+
+    dynamic_keymap_set_buffer(keymap_size - 2, sizeof(data), data);
+    EXPECT_EQ(dynamic_keymap_get_keycode(DYNAMIC_KEYMAP_LAYER_COUNT - 1, MATRIX_ROWS - 1, MATRIX_COLS - 1), 0x1234);
+
+    uint8_t read[4];
+    dynamic_keymap_get_buffer(keymap_size - 2, sizeof(read), read);
+    EXPECT_EQ(read[0], 0x12);
+    EXPECT_EQ(read[1], 0x34);
+    EXPECT_EQ(read[2], 0x00);
+    EXPECT_EQ(read[3], 0x00);
+}
+
+TEST_F(DynamicKeymapRamMirror, ResetReloadsTheMirror) {
+    ASSERT_EQ(dynamic_keymap_get_keycode(0, 1, 1), KC_NO);
+
+    /* Formatting the EEPROM doesn't go through the mirror, which still matches the default keymap. */
+    set_eeprom_keycode(0, 1, 1, 0xFFFF);
+    dynamic_keymap_reset();
+
+    EXPECT_EQ(eeprom_keycode(0, 1, 1), KC_NO);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 1), KC_NO);
+}
@@ -0,0 +1,123 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class DynamicMacroPlayback : public TestFixture {
+   protected:
+    KeymapKey record_key = KeymapKey(0, 0, 0, DM_REC1);
+    KeymapKey stop_key   = KeymapKey(0, 1, 0, DM_RSTP);
+    KeymapKey play_key   = KeymapKey(0, 2, 0, DM_PLY1);
+    KeymapKey key_a      = KeymapKey(0, 3, 0, KC_A);
+    KeymapKey key_b      = KeymapKey(0, 4, 0, KC_B);
+    KeymapKey key_c      = KeymapKey(0, 5, 0, KC_C);
+
+    void SetUp() override {
+        set_keymap({record_key, stop_key, play_key, key_a, key_b, key_c});
+    }
+
+    // Records "a", then "b" after a pause of gap ms.
+    void record_macro(TestDriver& driver, uint16_t gap) {
+        EXPECT_ANY_REPORT(driver).Times(AnyNumber());
+        tap_key(record_key);
+        tap_key(key_a);
+        idle_for(gap);
+        tap_key(key_b);
+        tap_key(stop_key);
+        VERIFY_AND_CLEAR(driver);
+    }
+};
+
+TEST_F(DynamicMacroPlayback, PlaysOneEventPerLoop) {
+    TestDriver driver;
+    InSequence s;
+
+    record_macro(driver, 0);
+
+    // Playback starts on release, with the first event
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    tap_key(play_key);
+    EXPECT_TRUE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    run_one_scan_loop();
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacroPlayback, ReplaysRecordedTiming) {
+    TestDriver driver;
+    InSequence s;
+
+    record_macro(driver, 30);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(play_key);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The pause between "a" and "b" is replayed without blocking
+    EXPECT_NO_REPORT(driver);
+    idle_for(20);
+    EXPECT_TRUE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    idle_for(30);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacroPlayback, KeyPressInterruptsPlayback) {
+    TestDriver driver;
+    InSequence s;
+
+    record_macro(driver, 30);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(play_key);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The rest of the macro is dropped
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_c);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    idle_for(50);
+    VERIFY_AND_CLEAR(driver);
+}
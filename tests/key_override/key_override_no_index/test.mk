@@ -0,0 +1,13 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+KEY_OVERRIDE_ENABLE = yes
+
+# The key override tests, without the trigger key index
+SRC += ../test_key_override.cpp
+
+INTROSPECTION_KEYMAP_C = ../test_key_overrides.c
@@ -0,0 +1,9 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// Smaller than the test overrides, which are checked one by one instead
+#define KEY_OVERRIDE_INDEX_LENGTH 4
@@ -0,0 +1,211 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "keymap_introspection.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+/* Number of overrides returned by key_override_count(), to change them at runtime. */
+static uint16_t visible_key_overrides = UINT16_MAX;
+
+extern "C" uint16_t key_override_count(void) {
+    return MIN(visible_key_overrides, key_override_count_raw());
+}
+
+class KeyOverride : public TestFixture {
+   public:
+    void SetUp() override {
+        visible_key_overrides = UINT16_MAX;
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+        key_override_index_invalidate();
+#endif
+    }
+};
+
+TEST_F(KeyOverride, trigger_pressed_with_mods_down_activates) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+    auto       key_bspc  = KeymapKey(0, 1, 0, KC_BACKSPACE);
+
+    set_keymap({key_shift, key_bspc});
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_shift.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_DELETE));
+    key_bspc.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_bspc.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, mod_pressed_after_last_key_activates) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+    auto       key_bspc  = KeymapKey(0, 1, 0, KC_BACKSPACE);
+
+    set_keymap({key_shift, key_bspc});
+
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    key_bspc.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The replacement is deferred until the key repeat delay (500ms) has passed. */
+    EXPECT_EMPTY_REPORT(driver);
+    key_shift.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_DELETE));
+    idle_for(500);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_bspc.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, first_listed_override_wins) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+    auto       key_1     = KeymapKey(0, 1, 0, KC_1);
+
+    set_keymap({key_shift, key_1});
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_shift.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_X));
+    key_1.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_1.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, override_matching_active_mods_wins) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_gui = KeymapKey(0, 0, 0, KC_LEFT_GUI);
+    auto       key_2   = KeymapKey(0, 1, 0, KC_2);
+
+    set_keymap({key_gui, key_2});
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI));
+    key_gui.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    key_2.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI));
+    key_2.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_gui.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, trigger_without_mods_is_not_overridden) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_bspc = KeymapKey(0, 0, 0, KC_BACKSPACE);
+
+    set_keymap({key_bspc});
+
+    EXPECT_REPORT(driver, (KC_BACKSPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_bspc);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyOverride, overrides_changed_at_runtime_apply) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_gui = KeymapKey(0, 0, 0, KC_LEFT_GUI);
+    auto       key_2   = KeymapKey(0, 1, 0, KC_2);
+
+    set_keymap({key_gui, key_2});
+
+    /* Without the last override, GUI + 2 is not overridden */
+    visible_key_overrides = key_override_count_raw() - 1;
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI));
+    key_gui.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI, KC_2));
+    key_2.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI));
+    key_2.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Once it is back, it is */
+    visible_key_overrides = UINT16_MAX;
+#ifdef KEY_OVERRIDE_INDEX_LENGTH
+    key_override_index_invalidate();
+#endif
+
+    EXPECT_REPORT(driver, (KC_C));
+    key_2.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_GUI));
+    key_2.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_gui.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
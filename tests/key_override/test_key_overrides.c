@@ -0,0 +1,20 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+// clang-format off
+const key_override_t *key_overrides[] = {
+    // Overrides for other triggers, which are never candidates in the tests
+    &ko_make_basic(MOD_MASK_CTRL, KC_F1, KC_F13),
+    &ko_make_basic(MOD_MASK_CTRL, KC_F2, KC_F14),
+    &ko_make_basic(MOD_MASK_CTRL, KC_F3, KC_F15),
+    &ko_make_basic(MOD_MASK_SHIFT, KC_BACKSPACE, KC_DELETE),
+    &ko_make_basic(MOD_MASK_CTRL, KC_F4, KC_F16),
+    // Same trigger: the first one listed wins
+    &ko_make_basic(MOD_MASK_SHIFT, KC_1, KC_X),
+    &ko_make_basic(MOD_MASK_SHIFT, KC_1, KC_Y),
+    // Same trigger, different modifiers
+    &ko_make_basic(MOD_MASK_ALT, KC_2, KC_B),
+    &ko_make_basic(MOD_MASK_GUI, KC_2, KC_C),
+};
+// clang-format on
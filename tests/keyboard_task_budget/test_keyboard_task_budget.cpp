@@ -0,0 +1,100 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+void advance_time(uint32_t ms);
+void simulate_async_tick(uint32_t t);
+}
+
+class KeyboardTaskBudget : public TestFixture {
+   public:
+    void TearDown() override {
+        simulate_async_tick(0);
+    }
+
+    // Lets deferred tasks catch up with earlier tests before measuring.
+    void settle() {
+        idle_for(KEYBOARD_TASK_MAX_DEFERRALS * 2);
+        keyboard_task_reset_stats();
+    }
+};
+
+TEST_F(KeyboardTaskBudget, RecordsScanIntervals) {
+    TestDriver driver;
+    settle();
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(5);
+    advance_time(10);
+    idle_for(5);
+    VERIFY_AND_CLEAR(driver);
+
+    const keyboard_task_stats_t *stats = keyboard_task_get_stats();
+    EXPECT_EQ(stats->loops, 10);
+    EXPECT_EQ(stats->scan_interval_min, 1);
+    EXPECT_EQ(stats->scan_interval_max, 11);
+    EXPECT_EQ(stats->deferrals, 0);
+    EXPECT_LT(stats->loop_time_max, KEYBOARD_TASK_BUDGET);
+}
+
+TEST_F(KeyboardTaskBudget, DefersLightingTasksWhenOverBudget) {
+    TestDriver driver;
+    settle();
+
+    // Every timer read now takes a whole budget, so each loop is over budget
+    // by the time the deferrable tasks are reached.
+    simulate_async_tick(KEYBOARD_TASK_BUDGET);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for((KEYBOARD_TASK_MAX_DEFERRALS + 1) * 2);
+    VERIFY_AND_CLEAR(driver);
+
+    // led_task is the only deferrable task in this build, and is never starved
+    // for more than KEYBOARD_TASK_MAX_DEFERRALS loops.
+    const keyboard_task_stats_t *stats = keyboard_task_get_stats();
+    EXPECT_EQ(stats->loops, (KEYBOARD_TASK_MAX_DEFERRALS + 1) * 2);
+    EXPECT_EQ(stats->deferrals, KEYBOARD_TASK_MAX_DEFERRALS * 2);
+    EXPECT_GE(stats->loop_time_max, KEYBOARD_TASK_BUDGET);
+}
+
+TEST_F(KeyboardTaskBudget, KeyPressesAreNotDelayed) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    settle();
+    simulate_async_tick(KEYBOARD_TASK_BUDGET);
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_GT(keyboard_task_get_stats()->deferrals, 0);
+}
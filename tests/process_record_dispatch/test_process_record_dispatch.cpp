@@ -0,0 +1,95 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "process_grave_esc.h"
+#include "process_tri_layer.h"
+}
+
+using testing::InSequence;
+
+static uint32_t process_record_user_calls = 0;
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    process_record_user_calls++;
+    return true;
+}
+
+class ProcessRecordDispatch : public TestFixture {
+   public:
+    void SetUp() override {
+        process_record_user_calls = 0;
+    }
+
+    /* Index of `handler` in the dispatch table, or the table size if it is not listed. */
+    uint8_t dispatch_index(bool (*handler)(uint16_t, keyrecord_t *)) {
+        uint8_t i = 0;
+        while (i < process_record_dispatch_count() && process_record_dispatch_get(i).handler != handler) {
+            i++;
+        }
+        return i;
+    }
+
+    /* Number of handlers process_record_quantum() calls for `keycode`, if none of them stops processing. */
+    uint8_t dispatched_handlers(uint16_t keycode) {
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < process_record_dispatch_count(); i++) {
+            process_record_dispatch_t entry = process_record_dispatch_get(i);
+            if (keycode >= entry.first && keycode <= entry.last) {
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+TEST_F(ProcessRecordDispatch, handlers_are_listed_in_order) {
+    uint8_t count = process_record_dispatch_count();
+
+    uint8_t kb        = dispatch_index(process_record_kb);
+    uint8_t caps_word = dispatch_index(process_caps_word);
+    uint8_t grave_esc = dispatch_index(process_grave_esc);
+    uint8_t tri_layer = dispatch_index(process_tri_layer);
+
+    ASSERT_LT(tri_layer, count);
+    EXPECT_LT(kb, caps_word);
+    EXPECT_LT(caps_word, grave_esc);
+    EXPECT_LT(grave_esc, tri_layer);
+
+    process_record_dispatch_t entry = process_record_dispatch_get(kb);
+    EXPECT_EQ(entry.first, 0x0000);
+    EXPECT_EQ(entry.last, 0xFFFF);
+
+    entry = process_record_dispatch_get(grave_esc);
+    EXPECT_EQ(entry.first, QK_GRAVE_ESCAPE);
+    EXPECT_EQ(entry.last, QK_GRAVE_ESCAPE);
+
+    EXPECT_EQ(process_record_dispatch_get(count).handler, nullptr);
+}
+
+TEST_F(ProcessRecordDispatch, handlers_only_see_keycodes_in_their_range) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a     = KeymapKey(0, 0, 0, KC_A);
+    auto       key_grave = KeymapKey(0, 1, 0, QK_GRAVE_ESCAPE);
+
+    set_keymap({key_a, key_grave});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_ESCAPE));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_grave);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Handlers seeing every key are still called for every event. */
+    EXPECT_EQ(process_record_user_calls, 4);
+
+    EXPECT_LT(dispatched_handlers(KC_A), dispatched_handlers(QK_GRAVE_ESCAPE));
+}
@@ -0,0 +1,113 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTrace : public TestFixture {
+   public:
+    void SetUp() override {
+        profiling_reset();
+    }
+
+    const profiling_zone_t* zone(const char* name) {
+        const profiling_zone_t* zone = profiling_zone_find(name);
+        EXPECT_NE(zone, nullptr) << name;
+        return zone;
+    }
+};
+
+TEST_F(LatencyTrace, RegularKeyIsReportedInTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key);
+    VERIFY_AND_CLEAR(driver);
+
+    auto report = zone("scan_to_report");
+    ASSERT_NE(report, nullptr);
+    EXPECT_EQ(report->count, 2);
+    EXPECT_EQ(report->max, 0);
+    EXPECT_EQ(zone("scan_to_exec")->max, 0);
+    EXPECT_EQ(zone("scan_to_process")->max, 0);
+}
+
+TEST_F(LatencyTrace, ModTapTapIsReportedOnRelease) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM / 2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The press is buffered by the tapping logic until the key is released.
+    auto process = zone("scan_to_process");
+    auto report  = zone("scan_to_report");
+    ASSERT_NE(process, nullptr);
+    ASSERT_NE(report, nullptr);
+    EXPECT_EQ(report->count, 2);
+    EXPECT_EQ(report->min, 0);
+    EXPECT_GE(report->max, TAPPING_TERM / 2);
+    EXPECT_LT(report->max, TAPPING_TERM);
+    EXPECT_EQ(process->max, report->max);
+    EXPECT_EQ(zone("scan_to_exec")->max, 0);
+}
+
+TEST_F(LatencyTrace, ModTapHoldIsReportedAfterTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    mod_tap_key.press();
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    auto report = zone("scan_to_report");
+    ASSERT_NE(report, nullptr);
+    EXPECT_EQ(report->count, 1);
+    EXPECT_GE(report->max, TAPPING_TERM);
+    EXPECT_LE(report->max, TAPPING_TERM + 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(report->count, 2);
+    EXPECT_EQ(report->min, 0);
+}
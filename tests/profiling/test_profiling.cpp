@@ -0,0 +1,146 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class Profiling : public TestFixture {
+   public:
+    void SetUp() override {
+        profiling_reset();
+    }
+
+    uint32_t histogram_total(const profiling_zone_t* zone) {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < PROFILING_HISTOGRAM_BUCKETS; i++) {
+            total += zone->histogram[i];
+        }
+        return total;
+    }
+};
+
+TEST_F(Profiling, RecordsMinMaxAverageAndHistogram) {
+    static profiling_zone_t zone = {.name = "recorded"};
+
+    profiling_zone_record(&zone, 0);
+    profiling_zone_record(&zone, 3);
+    profiling_zone_record(&zone, 5);
+    profiling_zone_record(&zone, 100);
+    profiling_zone_record(&zone, 1000);
+
+    EXPECT_EQ(profiling_zone_find("recorded"), &zone);
+    EXPECT_EQ(zone.count, 5);
+    EXPECT_EQ(zone.min, 0);
+    EXPECT_EQ(zone.max, 1000);
+    EXPECT_EQ(profiling_zone_average(&zone), 1108 / 5);
+
+    EXPECT_EQ(zone.histogram[0], 1); // 0
+    EXPECT_EQ(zone.histogram[1], 1); // 3
+    EXPECT_EQ(zone.histogram[2], 1); // 5
+    EXPECT_EQ(zone.histogram[6], 1); // 100
+    EXPECT_EQ(zone.histogram[7], 1); // 1000 saturates into the last bucket
+}
+
+TEST_F(Profiling, ResetKeepsZonesRegistered) {
+    static profiling_zone_t zone = {.name = "reset"};
+
+    profiling_zone_record(&zone, 42);
+    uint8_t count = profiling_zone_count();
+
+    profiling_reset();
+    EXPECT_EQ(profiling_zone_count(), count);
+    EXPECT_EQ(profiling_zone_find("reset"), &zone);
+    EXPECT_EQ(zone.count, 0);
+    EXPECT_EQ(profiling_zone_average(&zone), 0);
+    EXPECT_EQ(histogram_total(&zone), 0);
+
+    profiling_zone_record(&zone, 7);
+    EXPECT_EQ(profiling_zone_count(), count);
+    EXPECT_EQ(zone.min, 7);
+    EXPECT_EQ(zone.max, 7);
+}
+
+TEST_F(Profiling, ProfileZoneRegistersOnFirstUse) {
+    EXPECT_EQ(profiling_zone_find("macro zone"), nullptr);
+
+    int calls = 0;
+    for (int i = 0; i < 3; i++) {
+        PROFILE_ZONE("macro zone", calls++);
+    }
+
+    profiling_zone_t* zone = profiling_zone_find("macro zone");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(zone->count, 3);
+    EXPECT_LE(zone->min, zone->max);
+    EXPECT_EQ(histogram_total(zone), 3);
+}
+
+TEST_F(Profiling, KeyboardTaskSubtasksAreProfiled) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key);
+    VERIFY_AND_CLEAR(driver);
+
+    for (const char* name : {"matrix_task", "quantum_task"}) {
+        profiling_zone_t* zone = profiling_zone_find(name);
+        ASSERT_NE(zone, nullptr) << name;
+        EXPECT_GE(zone->count, 2) << name;
+        EXPECT_LE(zone->min, profiling_zone_average(zone)) << name;
+        EXPECT_LE(profiling_zone_average(zone), zone->max) << name;
+        EXPECT_EQ(histogram_total(zone), zone->count) << name;
+    }
+}
+
+TEST_F(Profiling, PackZone) {
+    static profiling_zone_t zone = {.name = "packed"};
+
+    profiling_zone_record(&zone, 2);
+    profiling_zone_record(&zone, 0x01020304);
+
+    uint8_t index = 0;
+    while (profiling_zone_get(index) != &zone) {
+        ASSERT_LT(++index, profiling_zone_count());
+    }
+
+    uint8_t data[32] = {0};
+    EXPECT_EQ(profiling_zone_pack(index, data, 15), 0);
+    EXPECT_EQ(profiling_zone_pack(profiling_zone_count(), data, sizeof(data)), 0);
+
+    // Header plus all 8 histogram buckets
+    ASSERT_EQ(profiling_zone_pack(index, data, sizeof(data)), 32);
+    EXPECT_EQ(data[0], 2);    // count
+    EXPECT_EQ(data[4], 2);    // min
+    EXPECT_EQ(data[8], 0x04); // max
+    EXPECT_EQ(data[9], 0x03);
+    EXPECT_EQ(data[10], 0x02);
+    EXPECT_EQ(data[11], 0x01);
+    EXPECT_EQ(data[16 + 2], 1);  // bucket 1 holds 2
+    EXPECT_EQ(data[16 + 14], 1); // bucket 7 holds the large sample
+
+    // Histogram is truncated to fit
+    EXPECT_EQ(profiling_zone_pack(index, data, 21), 20);
+}
@@ -0,0 +1,152 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class ReportCoalescing : public TestFixture {};
+
+TEST_F(ReportCoalescing, ChordInOneScanKeepsPressOrder) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+
+    /* Merging presses would lose the order they were typed in, so only the
+     * last one is held back. Releases are merged into one report. */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B, KC_C));
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ReportCoalescing, DuplicateReportsAreSuppressed) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_A));
+    register_code(KC_A);
+    run_one_scan_loop();
+    send_keyboard_report();
+    host_keyboard_send(keyboard_report);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    unregister_code(KC_A);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ReportCoalescing, TapsKeepPressReleaseOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    /* A tap is never merged away, so repeated taps of the same key all reach
+     * the host. Only the release of A and the press of B end up in one report. */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    tap_code(KC_A);
+    tap_code(KC_A);
+    tap_code(KC_B);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(HOST_REPORT_COALESCE_INTERVAL + 1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ReportCoalescing, ModsKeepPressReleaseOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    /* Shift is released and pressed again, and A is pressed on top of it, so
+     * none of that can be merged. A is sent once the interval has passed. */
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    register_code(KC_LSFT);
+    unregister_code(KC_LSFT);
+    register_code(KC_LSFT);
+    register_code(KC_A);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    idle_for(HOST_REPORT_COALESCE_INTERVAL + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    unregister_code(KC_A);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    unregister_code(KC_LSFT);
+    idle_for(HOST_REPORT_COALESCE_INTERVAL + 1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ReportCoalescing, RolloverKeepsTypingOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    /* The host sorts the keys of one report, so presses must not share one. */
+    EXPECT_REPORT(driver, (KC_T));
+    EXPECT_REPORT(driver, (KC_T, KC_H));
+    register_code(KC_T);
+    register_code(KC_H);
+    register_code(KC_E);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_T, KC_H, KC_E));
+    idle_for(HOST_REPORT_COALESCE_INTERVAL + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The interval has passed, so the first release goes out right away. */
+    EXPECT_REPORT(driver, (KC_H, KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    unregister_code(KC_T);
+    unregister_code(KC_H);
+    unregister_code(KC_E);
+    idle_for(HOST_REPORT_COALESCE_INTERVAL + 1);
+    VERIFY_AND_CLEAR(driver);
+}
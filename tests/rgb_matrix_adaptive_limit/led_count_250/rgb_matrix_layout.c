@@ -0,0 +1,68 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// One LED per key laid out like the matrix, then underglow LEDs filling the rest of the 25x10 grid.
+led_config_t g_led_config = {
+    {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    },
+    {
+        {0, 0}, {24, 0}, {48, 0}, {72, 0}, {96, 0}, {120, 0}, {144, 0}, {168, 0}, {192, 0}, {216, 0},
+        {0, 3}, {24, 3}, {48, 3}, {72, 3}, {96, 3}, {120, 3}, {144, 3}, {168, 3}, {192, 3}, {216, 3},
+        {0, 5}, {24, 5}, {48, 5}, {72, 5}, {96, 5}, {120, 5}, {144, 5}, {168, 5}, {192, 5}, {216, 5},
+        {0, 8}, {24, 8}, {48, 8}, {72, 8}, {96, 8}, {120, 8}, {144, 8}, {168, 8}, {192, 8}, {216, 8},
+        {0, 11}, {24, 11}, {48, 11}, {72, 11}, {96, 11}, {120, 11}, {144, 11}, {168, 11}, {192, 11}, {216, 11},
+        {0, 13}, {24, 13}, {48, 13}, {72, 13}, {96, 13}, {120, 13}, {144, 13}, {168, 13}, {192, 13}, {216, 13},
+        {0, 16}, {24, 16}, {48, 16}, {72, 16}, {96, 16}, {120, 16}, {144, 16}, {168, 16}, {192, 16}, {216, 16},
+        {0, 19}, {24, 19}, {48, 19}, {72, 19}, {96, 19}, {120, 19}, {144, 19}, {168, 19}, {192, 19}, {216, 19},
+        {0, 21}, {24, 21}, {48, 21}, {72, 21}, {96, 21}, {120, 21}, {144, 21}, {168, 21}, {192, 21}, {216, 21},
+        {0, 24}, {24, 24}, {48, 24}, {72, 24}, {96, 24}, {120, 24}, {144, 24}, {168, 24}, {192, 24}, {216, 24},
+        {0, 27}, {24, 27}, {48, 27}, {72, 27}, {96, 27}, {120, 27}, {144, 27}, {168, 27}, {192, 27}, {216, 27},
+        {0, 29}, {24, 29}, {48, 29}, {72, 29}, {96, 29}, {120, 29}, {144, 29}, {168, 29}, {192, 29}, {216, 29},
+        {0, 32}, {24, 32}, {48, 32}, {72, 32}, {96, 32}, {120, 32}, {144, 32}, {168, 32}, {192, 32}, {216, 32},
+        {0, 35}, {24, 35}, {48, 35}, {72, 35}, {96, 35}, {120, 35}, {144, 35}, {168, 35}, {192, 35}, {216, 35},
+        {0, 37}, {24, 37}, {48, 37}, {72, 37}, {96, 37}, {120, 37}, {144, 37}, {168, 37}, {192, 37}, {216, 37},
+        {0, 40}, {24, 40}, {48, 40}, {72, 40}, {96, 40}, {120, 40}, {144, 40}, {168, 40}, {192, 40}, {216, 40},
+        {0, 43}, {24, 43}, {48, 43}, {72, 43}, {96, 43}, {120, 43}, {144, 43}, {168, 43}, {192, 43}, {216, 43},
+        {0, 45}, {24, 45}, {48, 45}, {72, 45}, {96, 45}, {120, 45}, {144, 45}, {168, 45}, {192, 45}, {216, 45},
+        {0, 48}, {24, 48}, {48, 48}, {72, 48}, {96, 48}, {120, 48}, {144, 48}, {168, 48}, {192, 48}, {216, 48},
+        {0, 51}, {24, 51}, {48, 51}, {72, 51}, {96, 51}, {120, 51}, {144, 51}, {168, 51}, {192, 51}, {216, 51},
+        {0, 53}, {24, 53}, {48, 53}, {72, 53}, {96, 53}, {120, 53}, {144, 53}, {168, 53}, {192, 53}, {216, 53},
+        {0, 56}, {24, 56}, {48, 56}, {72, 56}, {96, 56}, {120, 56}, {144, 56}, {168, 56}, {192, 56}, {216, 56},
+        {0, 59}, {24, 59}, {48, 59}, {72, 59}, {96, 59}, {120, 59}, {144, 59}, {168, 59}, {192, 59}, {216, 59},
+        {0, 61}, {24, 61}, {48, 61}, {72, 61}, {96, 61}, {120, 61}, {144, 61}, {168, 61}, {192, 61}, {216, 61},
+        {0, 64}, {24, 64}, {48, 64}, {72, 64}, {96, 64}, {120, 64}, {144, 64}, {168, 64}, {192, 64}, {216, 64},
+    },
+    {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    },
+};
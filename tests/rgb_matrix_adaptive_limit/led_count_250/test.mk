@@ -0,0 +1,12 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+RGB_MATRIX_ENABLE = yes
+RGB_MATRIX_DRIVER = custom
+
+# The adaptive limit tests, with slice boundaries past 255
+SRC += test_rgb_matrix.c rgb_matrix_layout.c ../rgb_matrix_stub.c ../test_rgb_matrix_adaptive_limit.cpp
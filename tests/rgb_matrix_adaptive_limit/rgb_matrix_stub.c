@@ -0,0 +1,21 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "rgb_matrix_stub.h"
+
+void advance_time(uint32_t ms);
+
+uint32_t stub_cost_us_per_led = 0;
+
+static uint32_t stub_cost_remainder = 0;
+
+// Called once per render slice, after the effect.
+bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    if (led_max > led_min) {
+        stub_cost_remainder += stub_cost_us_per_led * (led_max - led_min);
+        advance_time(stub_cost_remainder / 1000);
+        stub_cost_remainder %= 1000;
+    }
+    return true;
+}
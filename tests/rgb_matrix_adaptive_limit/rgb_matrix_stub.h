@@ -0,0 +1,10 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "test_rgb_matrix.h"
+
+/* Simulated rendering cost, the timer is advanced by this much for every LED rendered. */
+extern uint32_t stub_cost_us_per_led;
@@ -0,0 +1,80 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix_stub.h"
+}
+
+class RgbMatrixAdaptiveLimit : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        stub_cost_us_per_led = 0;
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(HSV_RED);
+    }
+
+    /* Renders for long enough for the slice size to settle. */
+    void settle(uint32_t cost_us_per_led) {
+        stub_cost_us_per_led = cost_us_per_led;
+        idle_for(RGB_MATRIX_LED_PROCESS_ADAPT_INTERVAL * 8);
+    }
+
+    /* Renders for long enough to finish the current frame and a whole new one, even with one LED per slice. */
+    void render_frame() {
+        idle_for(RGB_MATRIX_LED_COUNT * (stub_cost_us_per_led + 1000) * 2 / 1000 + RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+    }
+};
+
+TEST_F(RgbMatrixAdaptiveLimit, slow_rendering_shrinks_slices_to_the_target) {
+    settle(250);
+    EXPECT_NEAR(rgb_matrix_get_process_limit(), RGB_MATRIX_LED_PROCESS_TARGET_US / 250, 1);
+
+    settle(1000);
+    EXPECT_NEAR(rgb_matrix_get_process_limit(), RGB_MATRIX_LED_PROCESS_TARGET_US / 1000, 1);
+}
+
+TEST_F(RgbMatrixAdaptiveLimit, fast_rendering_grows_slices_to_all_leds) {
+    settle(1000);
+    ASSERT_LT(rgb_matrix_get_process_limit(), RGB_MATRIX_LED_COUNT);
+
+    settle(0);
+    EXPECT_EQ(rgb_matrix_get_process_limit(), RGB_MATRIX_LED_COUNT);
+}
+
+TEST_F(RgbMatrixAdaptiveLimit, every_led_is_rendered_with_small_slices) {
+    settle(500);
+    ASSERT_LT(rgb_matrix_get_process_limit(), RGB_MATRIX_LED_COUNT / 4);
+
+    rgb_matrix_sethsv_noeeprom(HSV_WHITE);
+    render_frame();
+    RGB white = hsv_to_rgb((HSV){HSV_WHITE});
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_EQ(stub_colors[i][0], white.r) << "LED " << (int)i;
+        EXPECT_EQ(stub_colors[i][2], white.b) << "LED " << (int)i;
+    }
+}
+
+TEST_F(RgbMatrixAdaptiveLimit, every_slice_size_finishes_frames) {
+    // from one LED per slice to all of them, with the last slices ending past 255 on large boards
+    bool blue = false;
+    for (uint32_t cost_us_per_led : {2000, 1000, 300, 100, 30, 15, 12, 10, 8, 0}) {
+        settle(cost_us_per_led);
+        uint8_t limit = rgb_matrix_get_process_limit();
+
+        blue = !blue;
+        HSV hsv = blue ? (HSV){HSV_BLUE} : (HSV){HSV_RED};
+        rgb_matrix_sethsv_noeeprom(hsv.h, hsv.s, hsv.v);
+        render_frame();
+        RGB rgb = hsv_to_rgb(hsv);
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            ASSERT_EQ(stub_colors[i][0], rgb.r) << "LED " << (int)i << " with slices of " << (int)limit;
+            ASSERT_EQ(stub_colors[i][2], rgb.b) << "LED " << (int)i << " with slices of " << (int)limit;
+        }
+    }
+}
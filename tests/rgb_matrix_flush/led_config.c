@@ -0,0 +1,24 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// The first two LEDs share the first PWM transfer, the last LED has its
+// channels spread over three transfers.
+const is31fl3733_led_t PROGMEM g_is31fl3733_leds[IS31FL3733_LED_COUNT] = {
+    {0, SW1_CS1, SW1_CS2, SW1_CS3},
+    {0, SW1_CS4, SW1_CS5, SW1_CS6},
+    {0, SW2_CS1, SW2_CS2, SW2_CS3},
+    {0, SW10_CS1, SW11_CS1, SW12_CS1},
+};
+
+led_config_t g_led_config = {
+    {
+        {0, 1, 2, 3, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+        {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+        {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+        {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    },
+    {{0, 0}, {75, 0}, {150, 0}, {224, 0}},
+    {4, 4, 4, 4},
+};
@@ -0,0 +1,79 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "i2c_master.h"
+}
+
+/* Selecting the PWM page takes two single register writes. */
+#define PAGE_SELECT_TRANSFERS 2
+#define PAGE_SELECT_BYTES (PAGE_SELECT_TRANSFERS * 2)
+
+/* Each PWM transfer carries 16 registers after the register address. */
+#define PWM_TRANSFER_BYTES 17
+
+class RgbMatrixFlush : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(HSV_RED);
+        /* Let the initial frames go out before counting. */
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+        i2c_mock_reset();
+    }
+
+    /* Renders and flushes a few frames. */
+    void next_frames() {
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+    }
+};
+
+TEST_F(RgbMatrixFlush, static_effect_writes_nothing) {
+    next_frames();
+    EXPECT_EQ(i2c_mock_write_transfers(), 0);
+    EXPECT_EQ(i2c_mock_bytes_written(), 0);
+
+    rgb_matrix_sethsv_noeeprom(HSV_BLUE);
+    next_frames();
+    EXPECT_GT(i2c_mock_bytes_written(), 0);
+
+    i2c_mock_reset();
+    next_frames();
+    EXPECT_EQ(i2c_mock_bytes_written(), 0);
+}
+
+TEST_F(RgbMatrixFlush, single_led_change_writes_its_transfer) {
+    rgb_matrix_set_color(1, 0x10, 0x20, 0x30);
+    rgb_matrix_driver.flush();
+    EXPECT_EQ(i2c_mock_write_transfers(), PAGE_SELECT_TRANSFERS + 1);
+    EXPECT_EQ(i2c_mock_bytes_written(), PAGE_SELECT_BYTES + PWM_TRANSFER_BYTES);
+
+    i2c_mock_reset();
+    rgb_matrix_set_color(1, 0x10, 0x20, 0x30);
+    rgb_matrix_driver.flush();
+    EXPECT_EQ(i2c_mock_bytes_written(), 0);
+}
+
+TEST_F(RgbMatrixFlush, led_spread_over_transfers_writes_each_of_them) {
+    rgb_matrix_set_color(3, 0x10, 0x20, 0x30);
+    rgb_matrix_driver.flush();
+    EXPECT_EQ(i2c_mock_write_transfers(), PAGE_SELECT_TRANSFERS + 3);
+    EXPECT_EQ(i2c_mock_bytes_written(), PAGE_SELECT_BYTES + 3 * PWM_TRANSFER_BYTES);
+}
+
+TEST_F(RgbMatrixFlush, changes_are_coalesced_per_transfer) {
+    rgb_matrix_set_color_all(0x40, 0x50, 0x60);
+    rgb_matrix_driver.flush();
+    /* LEDs 0 and 1 share a transfer, LED 2 has its own and LED 3 uses three. */
+    EXPECT_EQ(i2c_mock_write_transfers(), PAGE_SELECT_TRANSFERS + 5);
+    EXPECT_EQ(i2c_mock_bytes_written(), PAGE_SELECT_BYTES + 5 * PWM_TRANSFER_BYTES);
+
+    /* The whole PWM page is 12 transfers. */
+    EXPECT_LT(i2c_mock_bytes_written(), PAGE_SELECT_BYTES + 12 * PWM_TRANSFER_BYTES);
+}
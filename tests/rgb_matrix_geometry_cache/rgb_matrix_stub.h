@@ -0,0 +1,11 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "test_rgb_matrix.h"
+
+/* Timer and colors as of the end of the last render. */
+extern uint32_t stub_rendered_timer;
+extern uint8_t  stub_rendered_colors[][3];
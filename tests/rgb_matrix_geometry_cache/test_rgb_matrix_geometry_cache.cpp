@@ -0,0 +1,79 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "lib/lib8tion/lib8tion.h"
+#include "rgb_matrix_stub.h"
+
+extern const led_point_t k_rgb_matrix_center;
+}
+
+static int16_t led_dx(uint8_t i) {
+    return g_led_config.point[i].x - k_rgb_matrix_center.x;
+}
+
+static int16_t led_dy(uint8_t i) {
+    return g_led_config.point[i].y - k_rgb_matrix_center.y;
+}
+
+/* The effects as they were before the cache, computing the geometry of every LED on every frame. */
+static HSV reference_pinwheel(HSV hsv, uint8_t i, uint8_t time) {
+    hsv.h = atan2_8(led_dy(i), led_dx(i)) + time;
+    return hsv;
+}
+
+static HSV reference_spiral(HSV hsv, uint8_t i, uint8_t time) {
+    int16_t dx   = led_dx(i);
+    int16_t dy   = led_dy(i);
+    uint8_t dist = sqrt16(dx * dx + dy * dy);
+    hsv.h        = dist - time - atan2_8(dy, dx);
+    return hsv;
+}
+
+class RgbMatrixGeometryCache : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+        rgb_matrix_sethsv_noeeprom(HSV_CYAN);
+        rgb_matrix_set_speed_noeeprom(RGB_MATRIX_DEFAULT_SPD);
+    }
+};
+
+TEST_F(RgbMatrixGeometryCache, cache_matches_the_uncached_helpers) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx = led_dx(i);
+        int16_t dy = led_dy(i);
+        EXPECT_EQ(g_rgb_geometry[i].dist, sqrt16(dx * dx + dy * dy)) << "LED " << (int)i;
+        EXPECT_EQ(g_rgb_geometry[i].angle, atan2_8(dy, dx)) << "LED " << (int)i;
+    }
+}
+
+TEST_F(RgbMatrixGeometryCache, effects_render_as_without_the_cache) {
+    struct {
+        const char *name;
+        uint8_t     mode;
+        HSV (*math)(HSV hsv, uint8_t i, uint8_t time);
+    } effects[] = {
+        {"CYCLE_PINWHEEL", RGB_MATRIX_CYCLE_PINWHEEL, reference_pinwheel},
+        {"CYCLE_SPIRAL", RGB_MATRIX_CYCLE_SPIRAL, reference_spiral},
+    };
+
+    for (auto &effect : effects) {
+        rgb_matrix_mode_noeeprom(effect.mode);
+        for (int frame = 0; frame < 20; frame++) {
+            idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2 + frame * 37);
+            uint8_t time = scale16by8(stub_rendered_timer, rgb_matrix_config.speed / 2);
+            for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+                RGB expected = hsv_to_rgb(effect.math(rgb_matrix_config.hsv, i, time));
+                EXPECT_EQ(stub_rendered_colors[i][0], expected.r) << effect.name << " LED " << (int)i;
+                EXPECT_EQ(stub_rendered_colors[i][1], expected.g) << effect.name << " LED " << (int)i;
+                EXPECT_EQ(stub_rendered_colors[i][2], expected.b) << effect.name << " LED " << (int)i;
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "rgb_matrix_stub.h"
+
+uint32_t stub_batch_calls  = 0;
+uint32_t stub_batch_colors = 0;
+
+void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    stub_batch_calls++;
+    stub_batch_colors += count;
+    hsv_to_rgb_batch(hsv, rgb, count);
+}
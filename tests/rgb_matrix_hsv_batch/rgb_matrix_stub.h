@@ -0,0 +1,10 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "test_rgb_matrix.h"
+
+extern uint32_t stub_batch_calls;
+extern uint32_t stub_batch_colors;
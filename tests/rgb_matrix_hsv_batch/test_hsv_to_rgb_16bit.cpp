@@ -0,0 +1,81 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+namespace int16_target {
+
+/* A uint16_t as seen by a compiler with a 16-bit int, like avr-gcc: it is promoted to unsigned int, so every
+ * operation on it wraps around at 16 bits. */
+struct uint16_avr {
+    uint16_t value;
+
+    uint16_avr(int v) : value((uint16_t)v) {}
+    explicit operator uint8_t() const {
+        return (uint8_t)value;
+    }
+};
+
+static inline uint16_avr operator+(uint16_avr a, uint16_avr b) {
+    return (uint16_t)(a.value + b.value);
+}
+static inline uint16_avr operator-(uint16_avr a, uint16_avr b) {
+    return (uint16_t)(a.value - b.value);
+}
+static inline uint16_avr operator*(uint16_avr a, uint16_avr b) {
+    return (uint16_t)((uint32_t)a.value * b.value);
+}
+static inline uint16_avr operator/(uint16_avr a, uint16_avr b) {
+    return (uint16_t)(a.value / b.value);
+}
+static inline uint16_avr operator>>(uint16_avr a, int b) {
+    return (uint16_t)(a.value >> b);
+}
+static inline uint16_avr operator+(uint16_avr a, int b) {
+    return a + uint16_avr(b);
+}
+static inline uint16_avr operator-(uint16_avr a, int b) {
+    return a - uint16_avr(b);
+}
+static inline uint16_avr operator-(int a, uint16_avr b) {
+    return uint16_avr(a) - b;
+}
+static inline uint16_avr operator*(uint16_avr a, int b) {
+    return a * uint16_avr(b);
+}
+static inline uint16_avr operator*(int a, uint16_avr b) {
+    return uint16_avr(a) * b;
+}
+static inline uint16_avr operator/(uint16_avr a, int b) {
+    return a / uint16_avr(b);
+}
+static inline bool operator==(uint16_avr a, int b) {
+    return a.value == (uint16_t)b;
+}
+
+/* The conversion in color.c, built with that arithmetic. */
+#define HSV_TO_RGB_UINT16 uint16_avr
+#include "color.c"
+#undef HSV_TO_RGB_UINT16
+
+} // namespace int16_target
+
+TEST(HsvToRgb16Bit, matches_with_16_bit_int) {
+    for (int v = 0; v < 256; v++) {
+        for (int s = 0; s < 256; s++) {
+            for (int h = 0; h < 256; h++) {
+                HSV hsv      = {(uint8_t)h, (uint8_t)s, (uint8_t)v};
+                RGB expected = hsv_to_rgb_nocie(hsv);
+                RGB actual   = int16_target::hsv_to_rgb_nocie(hsv);
+                ASSERT_EQ(actual.r, expected.r) << "h=" << h << " s=" << s << " v=" << v;
+                ASSERT_EQ(actual.g, expected.g) << "h=" << h << " s=" << s << " v=" << v;
+                ASSERT_EQ(actual.b, expected.b) << "h=" << h << " s=" << s << " v=" << v;
+            }
+        }
+    }
+}
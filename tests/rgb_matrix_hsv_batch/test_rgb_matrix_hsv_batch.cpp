@@ -0,0 +1,128 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "led_tables.h"
+#include "rgb_matrix_stub.h"
+}
+
+/* The per-LED conversion hsv_to_rgb() used before the batch API, with its switch on the hue region. */
+static RGB reference_hsv_to_rgb(HSV hsv) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h, s, v;
+
+#ifdef USE_CIE1931_CURVE
+    hsv.v = CIE1931_CURVE[hsv.v];
+#endif
+    if (hsv.s == 0) {
+        rgb.r = hsv.v;
+        rgb.g = hsv.v;
+        rgb.b = hsv.v;
+        return rgb;
+    }
+
+    h = hsv.h;
+    s = hsv.s;
+    v = hsv.v;
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v;
+            rgb.g = t;
+            rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q;
+            rgb.g = v;
+            rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p;
+            rgb.g = v;
+            rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p;
+            rgb.g = q;
+            rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t;
+            rgb.g = p;
+            rgb.b = v;
+            break;
+        default:
+            rgb.r = v;
+            rgb.g = p;
+            rgb.b = q;
+            break;
+    }
+
+    return rgb;
+}
+
+class RgbMatrixHsvBatch : public TestFixture {};
+
+TEST_F(RgbMatrixHsvBatch, batch_matches_per_led_conversion) {
+    std::vector<HSV> hsv(256);
+    std::vector<RGB> rgb(256);
+
+    for (uint8_t v : {0, 1, 64, 127, 128, 200, 255}) {
+        for (int s = 0; s < 256; s++) {
+            for (int h = 0; h < 256; h++) {
+                hsv[h] = {(uint8_t)h, (uint8_t)s, v};
+            }
+            hsv_to_rgb_batch(hsv.data(), rgb.data(), 255);
+            hsv_to_rgb_batch(&hsv[255], &rgb[255], 1);
+
+            for (int h = 0; h < 256; h++) {
+                RGB expected = reference_hsv_to_rgb(hsv[h]);
+                RGB single   = hsv_to_rgb(hsv[h]);
+                ASSERT_EQ(rgb[h].r, expected.r) << "h=" << h << " s=" << s << " v=" << (int)v;
+                ASSERT_EQ(rgb[h].g, expected.g) << "h=" << h << " s=" << s << " v=" << (int)v;
+                ASSERT_EQ(rgb[h].b, expected.b) << "h=" << h << " s=" << s << " v=" << (int)v;
+                ASSERT_EQ(single.r, expected.r);
+                ASSERT_EQ(single.g, expected.g);
+                ASSERT_EQ(single.b, expected.b);
+            }
+        }
+    }
+}
+
+TEST_F(RgbMatrixHsvBatch, runners_convert_in_batches) {
+    TestDriver driver;
+
+    rgb_matrix_enable_noeeprom();
+    rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_CYCLE_ALL);
+    rgb_matrix_sethsv_noeeprom(HSV_RED);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    stub_batch_calls  = 0;
+    stub_batch_colors = 0;
+    memset(stub_colors, 0, RGB_MATRIX_LED_COUNT * 3);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT);
+
+    /* One frame of 40 LEDs, converted 16 at a time. */
+    EXPECT_EQ(stub_batch_calls, 3);
+    EXPECT_EQ(stub_batch_colors, RGB_MATRIX_LED_COUNT);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_EQ(stub_colors[i][0], stub_colors[0][0]) << "LED " << (int)i;
+        EXPECT_EQ(stub_colors[i][1], stub_colors[0][1]) << "LED " << (int)i;
+        EXPECT_EQ(stub_colors[i][2], stub_colors[0][2]) << "LED " << (int)i;
+    }
+    EXPECT_GT(stub_colors[0][0] + stub_colors[0][1] + stub_colors[0][2], 0);
+}
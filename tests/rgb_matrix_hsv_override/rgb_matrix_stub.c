@@ -0,0 +1,16 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "rgb_matrix_stub.h"
+
+uint32_t stub_hsv_to_rgb_calls = 0;
+HSV      stub_hsv_to_rgb_last;
+
+// Halves the brightness, as keyboards limiting the LED current do.
+RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+    stub_hsv_to_rgb_calls++;
+    stub_hsv_to_rgb_last = hsv;
+    hsv.v /= 2;
+    return hsv_to_rgb(hsv);
+}
@@ -0,0 +1,11 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "test_rgb_matrix.h"
+#include "color.h"
+
+extern uint32_t stub_hsv_to_rgb_calls;
+extern HSV      stub_hsv_to_rgb_last;
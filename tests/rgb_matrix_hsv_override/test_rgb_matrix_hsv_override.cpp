@@ -0,0 +1,38 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix_stub.h"
+}
+
+class RgbMatrixHsvOverride : public TestFixture {};
+
+TEST_F(RgbMatrixHsvOverride, runners_go_through_the_override) {
+    TestDriver driver;
+
+    rgb_matrix_enable_noeeprom();
+    rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_CYCLE_ALL);
+    rgb_matrix_sethsv_noeeprom(HSV_RED);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    /* The batch hook keeps going through the override, frame after frame. */
+    for (int frame = 0; frame < 3; frame++) {
+        stub_hsv_to_rgb_calls = 0;
+        memset(stub_colors, 0, RGB_MATRIX_LED_COUNT * 3);
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT);
+
+        EXPECT_EQ(stub_hsv_to_rgb_calls, RGB_MATRIX_LED_COUNT);
+        HSV dimmed   = stub_hsv_to_rgb_last;
+        dimmed.v     = dimmed.v / 2;
+        RGB expected = hsv_to_rgb(dimmed);
+        EXPECT_GT(expected.r + expected.g + expected.b, 0);
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            EXPECT_EQ(stub_colors[i][0], expected.r) << "LED " << (int)i;
+            EXPECT_EQ(stub_colors[i][1], expected.g) << "LED " << (int)i;
+            EXPECT_EQ(stub_colors[i][2], expected.b) << "LED " << (int)i;
+        }
+    }
+}
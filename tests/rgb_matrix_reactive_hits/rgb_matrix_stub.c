@@ -0,0 +1,15 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "rgb_matrix_stub.h"
+
+uint8_t    stub_rendered_colors[RGB_MATRIX_LED_COUNT][3];
+last_hit_t stub_rendered_hits;
+
+// Called once per render slice, after the effect.
+bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    stub_rendered_hits = g_last_hit_tracker;
+    memcpy(stub_rendered_colors, stub_colors, sizeof(stub_rendered_colors));
+    return true;
+}
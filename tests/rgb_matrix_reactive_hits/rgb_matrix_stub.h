@@ -0,0 +1,12 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "test_rgb_matrix.h"
+#include "rgb_matrix.h"
+
+/* Hits and colors as of the end of the last render. */
+extern last_hit_t stub_rendered_hits;
+extern uint8_t    stub_rendered_colors[][3];
@@ -0,0 +1,188 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "lib/lib8tion/lib8tion.h"
+#include "rgb_matrix_stub.h"
+}
+
+typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
+
+/* The effect math, as used by the effects under test. */
+static HSV splash_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
+    uint16_t effect = tick - dist;
+    if (effect > 255) effect = 255;
+    hsv.h += effect;
+    hsv.v = qadd8(hsv.v, 255 - effect);
+    return hsv;
+}
+
+static HSV solid_splash_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
+    uint16_t effect = tick - dist;
+    if (effect > 255) effect = 255;
+    hsv.v = qadd8(hsv.v, 255 - effect);
+    return hsv;
+}
+
+static HSV nexus_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
+    uint16_t effect = tick - dist;
+    if (effect > 255) effect = 255;
+    if (dist > 72) effect = 255;
+    if ((dx > 8 || dx < -8) && (dy > 8 || dy < -8)) effect = 255;
+    hsv.h = rgb_matrix_config.hsv.h + dy / 4;
+    hsv.v = qadd8(hsv.v, 255 - effect);
+    return hsv;
+}
+
+static HSV wide_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
+    uint16_t effect = tick + dist * 5;
+    if (effect > 255) effect = 255;
+    hsv.v = qadd8(hsv.v, 255 - effect);
+    return hsv;
+}
+
+static HSV cross_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
+    uint16_t effect = tick + dist;
+    dx              = dx < 0 ? dx * -1 : dx;
+    dy              = dy < 0 ? dy * -1 : dy;
+    dx              = dx * 16 > 255 ? 255 : dx * 16;
+    dy              = dy * 16 > 255 ? 255 : dy * 16;
+    effect += dx > dy ? dy : dx;
+    if (effect > 255) effect = 255;
+    hsv.v = qadd8(hsv.v, 255 - effect);
+    return hsv;
+}
+
+/* The splash runner before the spatial pre-filter, computing the distance to every hit. */
+static RGB reference_splash(const last_hit_t &hits, uint8_t i, reactive_splash_f math) {
+    HSV hsv = rgb_matrix_config.hsv;
+    hsv.v   = 0;
+    for (uint8_t j = 0; j < hits.count; j++) {
+        int16_t  dx   = g_led_config.point[i].x - hits.x[j];
+        int16_t  dy   = g_led_config.point[i].y - hits.y[j];
+        uint8_t  dist = sqrt16(dx * dx + dy * dy);
+        uint16_t tick = scale16by8(hits.tick[j], qadd8(rgb_matrix_config.speed, 1));
+        hsv           = math(hsv, dx, dy, dist, tick);
+    }
+    hsv.v = scale8(hsv.v, rgb_matrix_config.hsv.v);
+    return hsv_to_rgb(hsv);
+}
+
+/* The reactive runner before the pre-filter, searching all hits for every LED. */
+static RGB reference_simple(const last_hit_t &hits, uint8_t i) {
+    uint16_t tick = 65535 / qadd8(rgb_matrix_config.speed, 1);
+    for (int j = hits.count - 1; j >= 0; j--) {
+        if (hits.index[j] == i && hits.tick[j] < tick) {
+            tick = hits.tick[j];
+            break;
+        }
+    }
+    uint16_t offset = scale16by8(tick, qadd8(rgb_matrix_config.speed, 1));
+    HSV      hsv    = rgb_matrix_config.hsv;
+    hsv.v           = scale8(255 - offset, hsv.v);
+    return hsv_to_rgb(hsv);
+}
+
+class RgbMatrixReactiveHits : public TestFixture {
+   public:
+    TestDriver driver;
+
+    void SetUp() override {
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_set_flags_noeeprom(LED_FLAG_ALL);
+        rgb_matrix_sethsv_noeeprom(HSV_CYAN);
+        rgb_matrix_set_speed_noeeprom(RGB_MATRIX_DEFAULT_SPD);
+        /* Let all previous hits expire. */
+        idle_for(UINT16_MAX + RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+    }
+
+    void hit(uint8_t led) {
+        rgb_matrix_handle_key_event(led / MATRIX_COLS, led % MATRIX_COLS, true);
+        rgb_matrix_handle_key_event(led / MATRIX_COLS, led % MATRIX_COLS, false);
+    }
+
+    /* Types a burst of keys spread over the board. */
+    void type_burst(uint8_t keys, uint8_t first, uint16_t interval) {
+        for (uint8_t k = 0; k < keys; k++) {
+            hit((first + k * 7) % RGB_MATRIX_LED_COUNT);
+            idle_for(interval);
+        }
+    }
+
+    void expect_rendered(const char *name, reactive_splash_f math) {
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            RGB expected = math ? reference_splash(stub_rendered_hits, i, math) : reference_simple(stub_rendered_hits, i);
+            EXPECT_EQ(stub_rendered_colors[i][0], expected.r) << name << " LED " << (int)i;
+            EXPECT_EQ(stub_rendered_colors[i][1], expected.g) << name << " LED " << (int)i;
+            EXPECT_EQ(stub_rendered_colors[i][2], expected.b) << name << " LED " << (int)i;
+        }
+    }
+};
+
+TEST_F(RgbMatrixReactiveHits, hits_are_kept_oldest_first_when_the_ring_wraps) {
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+
+    for (uint8_t k = 0; k < LED_HITS_TO_REMEMBER + 5; k++) {
+        hit(k % RGB_MATRIX_LED_COUNT);
+        idle_for(3);
+    }
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    ASSERT_EQ(stub_rendered_hits.count, LED_HITS_TO_REMEMBER);
+    for (uint8_t j = 0; j < LED_HITS_TO_REMEMBER; j++) {
+        EXPECT_EQ(stub_rendered_hits.index[j], (j + 5) % RGB_MATRIX_LED_COUNT);
+        EXPECT_EQ(stub_rendered_hits.x[j], g_led_config.point[stub_rendered_hits.index[j]].x);
+        EXPECT_EQ(stub_rendered_hits.y[j], g_led_config.point[stub_rendered_hits.index[j]].y);
+        if (j > 0) {
+            EXPECT_EQ(stub_rendered_hits.tick[j - 1] - stub_rendered_hits.tick[j], 3);
+        }
+    }
+}
+
+TEST_F(RgbMatrixReactiveHits, hits_expire_after_the_tick_range) {
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+
+    hit(1);
+    idle_for(1000);
+    hit(2);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+    EXPECT_EQ(stub_rendered_hits.count, 2);
+
+    idle_for(UINT16_MAX - 1000);
+    ASSERT_EQ(stub_rendered_hits.count, 1);
+    EXPECT_EQ(stub_rendered_hits.index[0], 2);
+
+    idle_for(1000);
+    EXPECT_EQ(stub_rendered_hits.count, 0);
+}
+
+TEST_F(RgbMatrixReactiveHits, effects_render_as_without_the_pre_filter) {
+    struct {
+        const char       *name;
+        uint8_t           mode;
+        reactive_splash_f math;
+    } effects[] = {
+        {"SOLID_REACTIVE_SIMPLE", RGB_MATRIX_SOLID_REACTIVE_SIMPLE, nullptr},
+        {"SOLID_REACTIVE_MULTIWIDE", RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE, wide_math},
+        {"SOLID_REACTIVE_MULTICROSS", RGB_MATRIX_SOLID_REACTIVE_MULTICROSS, cross_math},
+        {"SOLID_REACTIVE_MULTINEXUS", RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS, nexus_math},
+        {"MULTISPLASH", RGB_MATRIX_MULTISPLASH, splash_math},
+        {"SOLID_MULTISPLASH", RGB_MATRIX_SOLID_MULTISPLASH, solid_splash_math},
+    };
+    const uint8_t speeds[] = {0, 40, 127, 255};
+
+    for (auto &effect : effects) {
+        rgb_matrix_mode_noeeprom(effect.mode);
+        for (uint8_t speed : speeds) {
+            rgb_matrix_set_speed_noeeprom(speed);
+            type_burst(LED_HITS_TO_REMEMBER + 3, speed, 7);
+            for (int frame = 0; frame < 40; frame++) {
+                idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 3 + frame * 11);
+                ASSERT_GT(stub_rendered_hits.count, 0);
+                expect_rendered(effect.name, effect.math);
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/* Copyright 2023 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class SendStringQueue : public TestFixture {};
+
+TEST_F(SendStringQueue, QueuedStringIsSentFromMainLoop) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    send_string_queued_with_delay("aB", 0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_B));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_FALSE(send_string_queue_is_empty());
+        run_one_scan_loop();
+    }
+    EXPECT_TRUE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringQueue, DelayDoesNotBlock) {
+    TestDriver driver;
+    InSequence s;
+
+    SEND_STRING_QUEUED("a" SS_DELAY(5) "b");
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The delay is waited out by the main loop
+    EXPECT_NO_REPORT(driver);
+    for (int i = 0; i < 5; i++) {
+        run_one_scan_loop();
+    }
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_TRUE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringQueue, FullQueueSendsOldestSynchronously) {
+    TestDriver driver;
+    InSequence s;
+
+    // Ten actions in a queue of eight: the first two are sent right away
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    send_string_queued_with_delay("abcde", 0);
+    VERIFY_AND_CLEAR(driver);
+
+    for (uint16_t kc : {KC_B, KC_C, KC_D, KC_E}) {
+        EXPECT_REPORT(driver, (kc));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    for (int i = 0; i < 20 && !send_string_queue_is_empty(); i++) {
+        run_one_scan_loop();
+    }
+    EXPECT_TRUE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(SendStringQueue, UnicodeCharactersAreQueued) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    send_unicode_string_queued("é€");
+    EXPECT_FALSE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+
+    // Each character is input in one go, the main loop runs in between
+    EXPECT_ANY_REPORT(driver).Times(testing::AtLeast(1));
+    run_one_scan_loop();
+    EXPECT_FALSE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AtLeast(1));
+    run_one_scan_loop();
+    EXPECT_TRUE(send_string_queue_is_empty());
+    VERIFY_AND_CLEAR(driver);
+}
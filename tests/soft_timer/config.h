@@ -0,0 +1,9 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define CAPS_WORD_IDLE_TIMEOUT 1000
+#define LEADER_TIMEOUT 300
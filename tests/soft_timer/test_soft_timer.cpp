@@ -0,0 +1,112 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+static std::vector<int> calls;
+
+static void leader_callback(void) {
+    calls.push_back(SOFT_TIMER_LEADER);
+}
+
+static void caps_word_callback(void) {
+    calls.push_back(SOFT_TIMER_CAPS_WORD);
+}
+
+class SoftTimer : public TestFixture {
+   public:
+    void SetUp() override {
+        calls.clear();
+    }
+};
+
+TEST_F(SoftTimer, CallsDueTimersOnce) {
+    soft_timer_start(SOFT_TIMER_CAPS_WORD, 20, caps_word_callback);
+    soft_timer_start(SOFT_TIMER_LEADER, 10, leader_callback);
+    EXPECT_TRUE(soft_timer_pending(SOFT_TIMER_LEADER));
+    EXPECT_EQ(soft_timer_next(), 10);
+
+    advance_time(9);
+    soft_timer_task();
+    EXPECT_TRUE(calls.empty());
+    EXPECT_EQ(soft_timer_next(), 1);
+
+    advance_time(1);
+    soft_timer_task();
+    soft_timer_task();
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0], SOFT_TIMER_LEADER);
+    EXPECT_FALSE(soft_timer_pending(SOFT_TIMER_LEADER));
+    EXPECT_EQ(soft_timer_next(), 10);
+
+    advance_time(20);
+    EXPECT_EQ(soft_timer_next(), 0);
+    soft_timer_task();
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[1], SOFT_TIMER_CAPS_WORD);
+    EXPECT_EQ(soft_timer_next(), SOFT_TIMER_IDLE);
+}
+
+TEST_F(SoftTimer, RestartAndStop) {
+    soft_timer_start(SOFT_TIMER_LEADER, 10, leader_callback);
+    soft_timer_start(SOFT_TIMER_CAPS_WORD, 5, caps_word_callback);
+    soft_timer_stop(SOFT_TIMER_CAPS_WORD);
+    EXPECT_EQ(soft_timer_next(), 10);
+
+    advance_time(5);
+    soft_timer_start(SOFT_TIMER_LEADER, 10, leader_callback);
+    advance_time(5);
+    soft_timer_task();
+    EXPECT_TRUE(calls.empty());
+
+    advance_time(5);
+    soft_timer_task();
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0], SOFT_TIMER_LEADER);
+}
+
+TEST_F(SoftTimer, SimultaneousTimersRunInIdOrder) {
+    soft_timer_start(SOFT_TIMER_CAPS_WORD, 5, caps_word_callback);
+    soft_timer_start(SOFT_TIMER_LEADER, 10, leader_callback);
+
+    advance_time(10);
+    soft_timer_task();
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[0], SOFT_TIMER_LEADER);
+    EXPECT_EQ(calls[1], SOFT_TIMER_CAPS_WORD);
+}
+
+TEST_F(SoftTimer, FeaturesOnlyWaitWhileActive) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    idle_for(10);
+    EXPECT_EQ(soft_timer_next(), SOFT_TIMER_IDLE);
+
+    caps_word_on();
+    EXPECT_TRUE(soft_timer_pending(SOFT_TIMER_CAPS_WORD));
+    EXPECT_EQ(soft_timer_next(), CAPS_WORD_IDLE_TIMEOUT);
+
+    leader_start();
+    EXPECT_EQ(soft_timer_next(), LEADER_TIMEOUT + 1);
+
+    /* The leader sequence times out first, then caps word. idle_for() runs the task before advancing the time. */
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_FALSE(leader_sequence_active());
+    EXPECT_FALSE(soft_timer_pending(SOFT_TIMER_LEADER));
+    EXPECT_TRUE(is_caps_word_on());
+
+    idle_for(CAPS_WORD_IDLE_TIMEOUT);
+    EXPECT_FALSE(is_caps_word_on());
+    EXPECT_EQ(soft_timer_next(), SOFT_TIMER_IDLE);
+}
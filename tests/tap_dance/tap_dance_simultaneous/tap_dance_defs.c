@@ -0,0 +1,11 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "tap_dance_defs.h"
+
+tap_dance_action_t tap_dance_actions[] = {
+    [TD_A_B] = ACTION_TAP_DANCE_DOUBLE(KC_A, KC_B),
+    [TD_C_D] = ACTION_TAP_DANCE_DOUBLE(KC_C, KC_D),
+    [TD_E_F] = ACTION_TAP_DANCE_DOUBLE(KC_E, KC_F),
+};
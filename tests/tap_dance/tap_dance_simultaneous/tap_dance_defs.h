@@ -0,0 +1,18 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum tap_dance_ids {
+    TD_A_B, // ACTION_TAP_DANCE_DOUBLE(KC_A, KC_B)
+    TD_C_D, // ACTION_TAP_DANCE_DOUBLE(KC_C, KC_D)
+    TD_E_F, // ACTION_TAP_DANCE_DOUBLE(KC_E, KC_F)
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_keymap_key.hpp"
+#include "tap_dance_defs.h"
+
+using testing::_;
+using testing::InSequence;
+
+class TapDanceSimultaneous : public TestFixture {};
+
+TEST_F(TapDanceSimultaneous, RollDoesNotInterrupt) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey(0, 1, 0, TD(TD_A_B));
+    auto       key_cd = KeymapKey(0, 2, 0, TD(TD_C_D));
+
+    set_keymap({key_ab, key_cd});
+
+    /* Rolling onto the second tap dance key leaves the first one waiting */
+    EXPECT_NO_REPORT(driver);
+    key_ab.press();
+    run_one_scan_loop();
+    key_cd.press();
+    run_one_scan_loop();
+    key_ab.release();
+    run_one_scan_loop();
+    key_cd.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Both dances time out on their own, in order */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, DoubleTapAcrossAnotherDance) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey(0, 1, 0, TD(TD_A_B));
+    auto       key_cd = KeymapKey(0, 2, 0, TD(TD_C_D));
+
+    set_keymap({key_ab, key_cd});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The second tap of the first dance is not lost */
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ab);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, TimersAreIndependent) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey(0, 1, 0, TD(TD_A_B));
+    auto       key_cd = KeymapKey(0, 2, 0, TD(TD_C_D));
+
+    set_keymap({key_ab, key_cd});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    idle_for(TAPPING_TERM / 2);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The first dance times out a tapping term after its own tap */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM / 2);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The second one is still waiting for another tap */
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, RegularKeyInterruptsAll) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab      = KeymapKey(0, 1, 0, TD(TD_A_B));
+    auto       key_cd      = KeymapKey(0, 2, 0, TD(TD_C_D));
+    auto       regular_key = KeymapKey(0, 3, 0, KC_X);
+
+    set_keymap({key_ab, key_cd, regular_key});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Nothing is left to time out */
+    EXPECT_NO_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, FullQueueInterruptsFirstToTimeOut) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey(0, 1, 0, TD(TD_A_B));
+    auto       key_cd = KeymapKey(0, 2, 0, TD(TD_C_D));
+    auto       key_ef = KeymapKey(0, 3, 0, TD(TD_E_F));
+
+    set_keymap({key_ab, key_cd, key_ef});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+
+    /* A third dance does not fit, so the first one is finished to make room */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ef);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -224,3 +224,110 @@ TEST_F(DefaultTapHold, tap_and_hold_mod_tap_hold_key) {
     run_one_scan_loop();
     VERIFY_AND_CLEAR(driver);
 }
+
+TEST_F(DefaultTapHold, waiting_buffer_overflow_settles_mod_tap_key_as_hold) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       first_key        = KeymapKey(0, 2, 0, KC_A);
+    auto       second_key       = KeymapKey(0, 3, 0, KC_B);
+
+    set_keymap({mod_tap_hold_key, first_key, second_key});
+    waiting_buffer_reset_stats();
+
+    /* Press mod-tap-hold key. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Fill the waiting buffer with taps of regular keys. */
+    EXPECT_NO_REPORT(driver);
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        tap_key(i % 2 ? second_key : first_key);
+    }
+    EXPECT_EQ(waiting_buffer_get_stats()->peak_depth, WAITING_BUFFER_SIZE);
+    EXPECT_EQ(waiting_buffer_get_stats()->overflows, 0);
+    VERIFY_AND_CLEAR(driver);
+
+    /* One more key press settles the mod-tap-hold key as held, and nothing is lost. */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT, i % 2 ? KC_B : KC_A));
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    }
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    first_key.press();
+    run_one_scan_loop();
+    EXPECT_EQ(waiting_buffer_get_stats()->overflows, 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    first_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DefaultTapHold, waiting_buffer_overflow_keeps_order_behind_a_new_tapping_key) {
+    TestDriver driver;
+    InSequence s;
+    auto       first_mod_tap_key  = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       second_mod_tap_key = KeymapKey(0, 2, 0, LCTL_T(KC_Q));
+    auto       key_a              = KeymapKey(0, 3, 0, KC_A);
+    auto       key_b              = KeymapKey(0, 4, 0, KC_B);
+    auto       key_c              = KeymapKey(0, 5, 0, KC_C);
+    auto       key_d              = KeymapKey(0, 6, 0, KC_D);
+
+    set_keymap({first_mod_tap_key, second_mod_tap_key, key_a, key_b, key_c, key_d});
+    waiting_buffer_reset_stats();
+
+    /* Press the first mod-tap key, then fill the waiting buffer, starting with the second one. */
+    EXPECT_NO_REPORT(driver);
+    first_mod_tap_key.press();
+    run_one_scan_loop();
+    second_mod_tap_key.press();
+    run_one_scan_loop();
+    tap_key(key_a);
+    tap_key(key_b);
+    tap_key(key_c);
+    key_d.press();
+    run_one_scan_loop();
+    EXPECT_EQ(waiting_buffer_get_stats()->peak_depth, WAITING_BUFFER_SIZE);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Releasing the first mod-tap key taps it and overflows the buffer. The release waits behind the
+     * buffered events, which now wait for the second mod-tap key. */
+    EXPECT_REPORT(driver, (KC_P));
+    first_mod_tap_key.release();
+    run_one_scan_loop();
+    EXPECT_EQ(waiting_buffer_get_stats()->overflows, 1);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Once the second mod-tap key is held, everything is sent in the order it was typed. */
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL, KC_A));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL, KC_B));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL, KC_C));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_P, KC_LEFT_CTRL, KC_D));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_D));
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    second_mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
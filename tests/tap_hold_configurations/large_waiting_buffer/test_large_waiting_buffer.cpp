@@ -0,0 +1,69 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LargeWaitingBuffer : public TestFixture {};
+
+TEST_F(LargeWaitingBuffer, overflow_settles_mod_tap_key_as_hold) {
+    TestDriver             driver;
+    InSequence             s;
+    auto                   mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    std::vector<KeymapKey> keys;
+
+    /* Regular keys on all the other matrix positions, so the key index is well populated. */
+    for (uint8_t i = 1; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        keys.emplace_back(0, i % MATRIX_COLS, i / MATRIX_COLS, KC_A + (i % 26));
+    }
+    set_keymap({mod_tap_hold_key});
+    for (auto &key : keys) {
+        add_key(key);
+    }
+    waiting_buffer_reset_stats();
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Fill the waiting buffer with taps of regular keys. */
+    EXPECT_NO_REPORT(driver);
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        tap_key(keys[i % keys.size()]);
+    }
+    EXPECT_EQ(waiting_buffer_get_stats()->peak_depth, WAITING_BUFFER_SIZE);
+    EXPECT_EQ(waiting_buffer_get_stats()->overflows, 0);
+    VERIFY_AND_CLEAR(driver);
+
+    /* One more key press settles the mod-tap-hold key as held, and nothing is lost. */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    for (int i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT, keys[i % keys.size()].code));
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    }
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, keys[0].code));
+    keys[0].press();
+    run_one_scan_loop();
+    EXPECT_EQ(waiting_buffer_get_stats()->overflows, 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    keys[0].release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,54 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "test_rgb_matrix.h"
+
+uint8_t stub_colors[RGB_MATRIX_LED_COUNT][3];
+
+static void stub_init(void) {}
+
+static void stub_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    stub_colors[index][0] = r;
+    stub_colors[index][1] = g;
+    stub_colors[index][2] = b;
+}
+
+static void stub_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        stub_set_color(i, r, g, b);
+    }
+}
+
+static void stub_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = stub_init,
+    .set_color     = stub_set_color,
+    .set_color_all = stub_set_color_all,
+    .flush         = stub_flush,
+};
+
+#if RGB_MATRIX_LED_COUNT == 40
+// One LED per key, laid out like the matrix.
+led_config_t g_led_config = {
+    {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    },
+    {
+        {0, 0}, {24, 0}, {48, 0}, {72, 0}, {96, 0}, {120, 0}, {144, 0}, {168, 0}, {192, 0}, {216, 0},
+        {0, 21}, {24, 21}, {48, 21}, {72, 21}, {96, 21}, {120, 21}, {144, 21}, {168, 21}, {192, 21}, {216, 21},
+        {0, 42}, {24, 42}, {48, 42}, {72, 42}, {96, 42}, {120, 42}, {144, 42}, {168, 42}, {192, 42}, {216, 42},
+        {0, 64}, {24, 64}, {48, 64}, {72, 64}, {96, 64}, {120, 64}, {144, 64}, {168, 64}, {192, 64}, {216, 64},
+    },
+    {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    },
+};
+#endif
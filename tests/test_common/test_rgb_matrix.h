@@ -0,0 +1,14 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/* A custom RGB matrix driver and a layout of one LED per key of the test
+ * matrix. Tests using them set RGB_MATRIX_DRIVER = custom, define
+ * RGB_MATRIX_LED_COUNT to 40 and add test_rgb_matrix.c to SRC. Tests with
+ * another LED count bring their own g_led_config. */
+
+/* The colors last set by the driver. */
+extern uint8_t stub_colors[][3];
@@ -0,0 +1,10 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define TICKLESS_IDLE
+#define ONESHOT_TIMEOUT 500
+#define CAPS_WORD_IDLE_TIMEOUT 1000
@@ -0,0 +1,129 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+static std::vector<uint32_t> idle_waits;
+
+extern "C" void keyboard_idle_wait(uint32_t max_ms) {
+    idle_waits.push_back(max_ms);
+}
+
+static uint32_t deferred_callback(uint32_t trigger_time, void *cb_arg) {
+    return 0;
+}
+
+class TicklessIdle : public TestFixture {
+   public:
+    void SetUp() override {
+        idle_waits.clear();
+    }
+};
+
+TEST_F(TicklessIdle, NothingScheduledIdlesForever) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_FALSE(action_tick_pending());
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+
+    /* A plain key held down leaves nothing to wait for. */
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    keyboard_idle_task();
+    EXPECT_EQ(idle_waits, std::vector<uint32_t>({KEYBOARD_IDLE_FOREVER}));
+}
+
+TEST_F(TicklessIdle, TappingKeyKeepsTicking) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, LSFT_T(KC_A));
+
+    set_keymap({mod_tap_key});
+
+    /* Ticks still settle a held mod-tap key once the tapping term is over. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(action_tick_pending());
+    EXPECT_EQ(keyboard_idle_time(), 0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    idle_for(TAPPING_TERM);
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* A tap keeps them going until a following tap could no longer count. */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(mod_tap_key);
+    EXPECT_EQ(keyboard_idle_time(), 0);
+    VERIFY_AND_CLEAR(driver);
+
+    idle_for(TAPPING_TERM);
+    EXPECT_FALSE(action_tick_pending());
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+}
+
+TEST_F(TicklessIdle, OneShotModKeepsTickingUntilTimeout) {
+    TestDriver driver;
+    auto       osm_key = KeymapKey(0, 0, 0, OSM(MOD_LSFT), KC_LSFT);
+
+    set_keymap({osm_key});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(osm_key);
+    EXPECT_EQ(get_oneshot_mods(), MOD_BIT(KC_LSFT));
+    EXPECT_EQ(keyboard_idle_time(), 0);
+
+    idle_for(ONESHOT_TIMEOUT);
+    EXPECT_EQ(get_oneshot_mods(), 0);
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TicklessIdle, WaitsForNextTimeout) {
+    caps_word_on();
+    EXPECT_EQ(keyboard_idle_time(), CAPS_WORD_IDLE_TIMEOUT);
+
+    deferred_token token = defer_exec(100, deferred_callback, NULL);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(keyboard_idle_time(), 100);
+
+    advance_time(40);
+    keyboard_idle_task();
+    EXPECT_EQ(idle_waits, std::vector<uint32_t>({60}));
+
+    EXPECT_TRUE(cancel_deferred_exec(token));
+    EXPECT_EQ(keyboard_idle_time(), CAPS_WORD_IDLE_TIMEOUT - 40);
+
+    caps_word_off();
+    EXPECT_EQ(keyboard_idle_time(), KEYBOARD_IDLE_FOREVER);
+}
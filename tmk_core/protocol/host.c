@@ -40,6 +40,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern keymap_config_t keymap_config;
 #endif
 
+#ifdef PROFILING_LATENCY_TRACE
+#    include "profiling.h"
+#endif
+
+#ifdef HOST_REPORT_COALESCE_INTERVAL
+#    include <string.h>
+#    include "timer.h"
+#endif
+
 static host_driver_t *driver;
 static uint16_t       last_system_usage   = 0;
 static uint16_t       last_consumer_usage = 0;
@@ -71,8 +80,176 @@ led_t host_keyboard_led_state(void) {
     return (led_t)host_keyboard_leds();
 }
 
-/* send report */
+static void host_keyboard_send_report(report_keyboard_t *report);
+static void host_nkro_send_report(report_nkro_t *report);
+
+#ifdef HOST_REPORT_COALESCE_INTERVAL
+/* Reports produced within HOST_REPORT_COALESCE_INTERVAL of the last one sent on
+ * the same endpoint are held back, and merged with later ones as long as this
+ * doesn't hide a press or a release from the host. Held back reports are sent by
+ * host_report_coalesce_task(), or as soon as merging would lose a change. */
+typedef struct {
+    fast_timer_t last_send;
+    bool         sent;
+    bool         pending;
+} report_coalesce_t;
+
+static report_keyboard_t keyboard_last;
+static report_keyboard_t keyboard_pending;
+static report_coalesce_t keyboard_coalesce;
+
+static bool keyboard_report_has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Whether next can replace pending: no key or mod pressed in pending is released
+ * in next, none released in pending is pressed again, and next doesn't press
+ * another one on top of a press in pending, which would lose the typing order. */
+static bool keyboard_report_can_merge(const report_keyboard_t *last, const report_keyboard_t *pending, const report_keyboard_t *next) {
+    uint8_t pressed_mods  = pending->mods & ~last->mods;
+    uint8_t released_mods = last->mods & ~pending->mods;
+    if ((pressed_mods & ~next->mods) || (released_mods & next->mods)) {
+        return false;
+    }
+    bool pending_presses = pressed_mods;
+    bool next_presses    = next->mods & ~pending->mods;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = pending->keys[i];
+        if (key && !keyboard_report_has_key(last, key)) {
+            if (!keyboard_report_has_key(next, key)) {
+                return false;
+            }
+            pending_presses = true;
+        }
+        key = last->keys[i];
+        if (key && !keyboard_report_has_key(pending, key) && keyboard_report_has_key(next, key)) {
+            return false;
+        }
+        key = next->keys[i];
+        if (key && !keyboard_report_has_key(pending, key)) {
+            next_presses = true;
+        }
+    }
+    return !(pending_presses && next_presses);
+}
+
+static void keyboard_coalesce_send(report_keyboard_t *report) {
+    memcpy(&keyboard_last, report, sizeof(report_keyboard_t));
+    keyboard_coalesce.last_send = timer_read_fast();
+    keyboard_coalesce.sent      = true;
+    keyboard_coalesce.pending   = false;
+    host_keyboard_send_report(report);
+}
+
+void host_keyboard_send(report_keyboard_t *report) {
+    if (keyboard_coalesce.pending) {
+        if (keyboard_report_can_merge(&keyboard_last, &keyboard_pending, report)) {
+            memcpy(&keyboard_pending, report, sizeof(report_keyboard_t));
+            return;
+        }
+        keyboard_coalesce_send(&keyboard_pending);
+    }
+
+    /* Like send_6kro_report(), let repeats through on V-USB: its driver drops a
+     * report when the endpoint stays busy, and a repeat gets it to the host.
+     * send_nkro_report() drops repeats on every protocol, so host_nkro_send()
+     * does too. */
+#    ifndef PROTOCOL_VUSB
+    if (memcmp(report, &keyboard_last, sizeof(report_keyboard_t)) == 0) {
+        return;
+    }
+#    endif
+
+    if (keyboard_coalesce.sent && timer_elapsed_fast(keyboard_coalesce.last_send) < HOST_REPORT_COALESCE_INTERVAL) {
+        memcpy(&keyboard_pending, report, sizeof(report_keyboard_t));
+        keyboard_coalesce.pending = true;
+        return;
+    }
+    keyboard_coalesce_send(report);
+}
+
+static report_nkro_t     nkro_last;
+static report_nkro_t     nkro_pending;
+static report_coalesce_t nkro_coalesce;
+
+static bool nkro_report_can_merge(const report_nkro_t *last, const report_nkro_t *pending, const report_nkro_t *next) {
+    uint8_t pressed  = pending->mods & ~last->mods;
+    uint8_t released = last->mods & ~pending->mods;
+    if ((pressed & ~next->mods) || (released & next->mods)) {
+        return false;
+    }
+    bool pending_presses = pressed;
+    bool next_presses    = next->mods & ~pending->mods;
+    for (uint8_t i = 0; i < NKRO_REPORT_BITS; i++) {
+        pressed  = pending->bits[i] & ~last->bits[i];
+        released = last->bits[i] & ~pending->bits[i];
+        if ((pressed & ~next->bits[i]) || (released & next->bits[i])) {
+            return false;
+        }
+        pending_presses |= pressed;
+        next_presses |= next->bits[i] & ~pending->bits[i];
+    }
+    return !(pending_presses && next_presses);
+}
+
+static void nkro_coalesce_send(report_nkro_t *report) {
+    memcpy(&nkro_last, report, sizeof(report_nkro_t));
+    nkro_coalesce.last_send = timer_read_fast();
+    nkro_coalesce.sent      = true;
+    nkro_coalesce.pending   = false;
+    host_nkro_send_report(report);
+}
+
+void host_nkro_send(report_nkro_t *report) {
+    if (nkro_coalesce.pending) {
+        if (nkro_report_can_merge(&nkro_last, &nkro_pending, report)) {
+            memcpy(&nkro_pending, report, sizeof(report_nkro_t));
+            return;
+        }
+        nkro_coalesce_send(&nkro_pending);
+    }
+
+    if (memcmp(report, &nkro_last, sizeof(report_nkro_t)) == 0) {
+        return;
+    }
+
+    if (nkro_coalesce.sent && timer_elapsed_fast(nkro_coalesce.last_send) < HOST_REPORT_COALESCE_INTERVAL) {
+        memcpy(&nkro_pending, report, sizeof(report_nkro_t));
+        nkro_coalesce.pending = true;
+        return;
+    }
+    nkro_coalesce_send(report);
+}
+
+void host_report_coalesce_task(void) {
+    if (keyboard_coalesce.pending && timer_elapsed_fast(keyboard_coalesce.last_send) >= HOST_REPORT_COALESCE_INTERVAL) {
+        keyboard_coalesce_send(&keyboard_pending);
+    }
+    if (nkro_coalesce.pending && timer_elapsed_fast(nkro_coalesce.last_send) >= HOST_REPORT_COALESCE_INTERVAL) {
+        nkro_coalesce_send(&nkro_pending);
+    }
+}
+
+bool host_report_coalesce_pending(void) {
+    return keyboard_coalesce.pending || nkro_coalesce.pending;
+}
+
+#else
 void host_keyboard_send(report_keyboard_t *report) {
+    host_keyboard_send_report(report);
+}
+
+void host_nkro_send(report_nkro_t *report) {
+    host_nkro_send_report(report);
+}
+#endif // HOST_REPORT_COALESCE_INTERVAL
+
+static void host_keyboard_send_report(report_keyboard_t *report) {
 #ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
         bluetooth_send_keyboard(report);
@@ -86,6 +263,10 @@ void host_keyboard_send(report_keyboard_t *report) {
 #endif
     (*driver->send_keyboard)(report);
 
+#ifdef PROFILING_LATENCY_TRACE
+    profiling_latency_report_sent();
+#endif
+
     if (debug_keyboard) {
         dprintf("keyboard_report: %02X | ", report->mods);
         for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -95,11 +276,15 @@ void host_keyboard_send(report_keyboard_t *report) {
     }
 }
 
-void host_nkro_send(report_nkro_t *report) {
+static void host_nkro_send_report(report_nkro_t *report) {
     if (!driver) return;
     report->report_id = REPORT_ID_NKRO;
     (*driver->send_nkro)(report);
 
+#ifdef PROFILING_LATENCY_TRACE
+    profiling_latency_report_sent();
+#endif
+
     if (debug_keyboard) {
         dprintf("nkro_report: %02X | ", report->mods);
         for (uint8_t i = 0; i < NKRO_REPORT_BITS; i++) {
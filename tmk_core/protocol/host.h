@@ -47,6 +47,13 @@ void    host_programmable_button_send(uint32_t data);
 uint16_t host_last_system_usage(void);
 uint16_t host_last_consumer_usage(void);
 
+#ifdef HOST_REPORT_COALESCE_INTERVAL
+/* sends keyboard reports that have been held back for coalescing */
+void host_report_coalesce_task(void);
+/* whether reports are still held back for coalescing */
+bool host_report_coalesce_pending(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
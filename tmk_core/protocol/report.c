@@ -22,6 +22,12 @@
 #include "util.h"
 #include <string.h>
 
+/* Keys currently added to the report, whatever the protocol in use. Both the
+ * 6KRO array and the NKRO bitmap are updated from it, so they always agree,
+ * and lookups don't have to scan either of them. */
+static uint8_t pressed_keys[256 / 8];
+static uint8_t pressed_key_count = 0;
+
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
 #    define RO_ADD(a, b) ((a + b) % KEYBOARD_REPORT_KEYS)
 #    define RO_SUB(a, b) ((a - b + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS)
@@ -34,22 +40,10 @@ static int8_t cb_count = 0;
 
 /** \brief has_anykey
  *
- * FIXME: Needs doc
+ * Returns the number of keys in the report, not counting modifiers.
  */
 uint8_t has_anykey(void) {
-    uint8_t  cnt = 0;
-    uint8_t* p   = keyboard_report->keys;
-    uint8_t  lp  = sizeof(keyboard_report->keys);
-#ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        p  = nkro_report->bits;
-        lp = sizeof(nkro_report->bits);
-    }
-#endif
-    while (lp--) {
-        if (*p++) cnt++;
-    }
-    return cnt;
+    return pressed_key_count;
 }
 
 /** \brief get_first_key
@@ -81,28 +75,15 @@ uint8_t get_first_key(void) {
 
 /** \brief Checks if a key is pressed in the report
  *
- * Returns true if the keyboard_report reports that the key is pressed, otherwise false
+ * Returns true if the key has been added to the report, otherwise false. With 6KRO, this
+ * includes keys that didn't fit in the report.
  * Note: The function doesn't support modifers currently, and it returns false for KC_NO
  */
 bool is_key_pressed(uint8_t key) {
     if (key == KC_NO) {
         return false;
     }
-#ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        if ((key >> 3) < NKRO_REPORT_BITS) {
-            return nkro_report->bits[key >> 3] & 1 << (key & 7);
-        } else {
-            return false;
-        }
-    }
-#endif
-    for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == key) {
-            return true;
-        }
-    }
-    return false;
+    return pressed_keys[key >> 3] & (1 << (key & 7));
 }
 
 /** \brief add key byte
@@ -242,13 +223,16 @@ void del_key_bit(report_nkro_t* nkro_report, uint8_t code) {
  * FIXME: Needs doc
  */
 void add_key_to_report(uint8_t key) {
-#ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        add_key_bit(nkro_report, key);
+    if (is_key_pressed(key) || key == KC_NO) {
         return;
     }
-#endif
+    pressed_keys[key >> 3] |= 1 << (key & 7);
+    pressed_key_count++;
+
     add_key_byte(keyboard_report, key);
+#ifdef NKRO_ENABLE
+    add_key_bit(nkro_report, key);
+#endif
 }
 
 /** \brief del key from report
@@ -256,13 +240,16 @@ void add_key_to_report(uint8_t key) {
  * FIXME: Needs doc
  */
 void del_key_from_report(uint8_t key) {
-#ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        del_key_bit(nkro_report, key);
+    if (!is_key_pressed(key)) {
         return;
     }
-#endif
+    pressed_keys[key >> 3] &= ~(1 << (key & 7));
+    pressed_key_count--;
+
     del_key_byte(keyboard_report, key);
+#ifdef NKRO_ENABLE
+    del_key_bit(nkro_report, key);
+#endif
 }
 
 /** \brief clear key from report
@@ -271,13 +258,16 @@ void del_key_from_report(uint8_t key) {
  */
 void clear_keys_from_report(void) {
     // not clear mods
+    memset(pressed_keys, 0, sizeof(pressed_keys));
+    pressed_key_count = 0;
+
+    memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    cb_head = cb_tail = cb_count = 0;
+#endif
 #ifdef NKRO_ENABLE
-    if (keyboard_protocol && keymap_config.nkro) {
-        memset(nkro_report->bits, 0, sizeof(nkro_report->bits));
-        return;
-    }
+    memset(nkro_report->bits, 0, sizeof(nkro_report->bits));
 #endif
-    memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
 }
 
 #ifdef MOUSE_ENABLE